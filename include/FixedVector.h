@@ -0,0 +1,316 @@
+#pragma once
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <new>
+#include "RC.h"
+#include "IVector.h"
+#include "Interfacedllexport.h"
+
+/*
+* Vector of compile-time dimension N with coordinates stored inside the object
+*
+* Loops over coordinates have constant trip count and are unrolled, and a FixedVector may live on the stack or inside
+* another object, so small problems need no heap at all. createVector, clone, add, sub and createLinearCombination
+* return FixedVector for dimensions 2, 3, 4 and 8 automatically, it is an ordinary IVector for ISet and ICompact.
+* Vectors created with new take memory from the vector pool, like all other vectors
+*
+* Members are defined in this header, so calls through a FixedVector<N> are inlined and unrolled where they are made.
+* Only the rare paths (logging, overflow policy, the pool) are out of line in FixedVectorBase
+*/
+class LIB_EXPORT FixedVectorBase {
+protected:
+    static void log(RC code, const char* srcfile, const char* function, int line);
+    static RC setDataOf(double* coords, size_t n, size_t dim, double const* ptr_data);
+    static RC scaleOf(double* coords, size_t n, double multiplier);
+    static RC combineOf(double* coords, size_t n, IVector const* op, double sign);
+    static RC applyOf(double* coords, size_t n, const std::function<double(double)>& fun);
+    static RC applyBatchOf(double* coords, size_t n, const std::function<void(double* values, size_t count)>& fun);
+    static void* allocate(size_t size);
+    static void deallocate(void* ptr);
+};
+
+template <size_t N>
+class LIB_EXPORT FixedVector final : public IVector, private FixedVectorBase {
+    static_assert(N == 2 || N == 3 || N == 4 || N == 8, "FixedVector is instantiated for dimensions 2, 3, 4 and 8");
+
+public:
+    /*
+    * Zero vector
+    */
+    FixedVector();
+    /*
+    * Copies N coordinates as they are, use setData to have them validated
+    */
+    explicit FixedVector(double const* ptr_data);
+
+    double* getMutableData();
+
+    IVector* clone() const override;
+    double const* getData() const override;
+    RC setData(size_t dim, double const* const& ptr_data) override;
+
+    RC getCord(size_t index, double& val) const override;
+    RC setCord(size_t index, double val) override;
+    RC scale(double multiplier) override;
+    size_t getDim() const override;
+
+    RC inc(IVector const* const& op) override;
+    RC dec(IVector const* const& op) override;
+
+    double norm(NORM n) const override;
+
+    using IVector::applyFunction;
+    using IVector::foreach;
+
+    RC applyFunction(const std::function<double(double)>& fun) override;
+    RC foreach(const std::function<void(double)>& fun) const override;
+    RC applyBatch(const std::function<void(double* values, size_t count)>& fun) override;
+
+    size_t sizeAllocated() const override;
+
+    ~FixedVector() override;
+
+    static void* operator new(size_t size);
+    static void* operator new(size_t size, const std::nothrow_t&) noexcept;
+    static void operator delete(void* ptr);
+
+private:
+    RC combine(IVector const* op, double sign);
+
+    double coords[N];
+};
+
+template <size_t N>
+FixedVector<N>::FixedVector() : coords()
+{
+}
+
+template <size_t N>
+FixedVector<N>::FixedVector(double const* ptr_data)
+{
+    for (size_t i = 0; i < N; ++i)
+        coords[i] = ptr_data[i];
+}
+
+template <size_t N>
+FixedVector<N>::~FixedVector() = default;
+
+template <size_t N>
+void* FixedVector<N>::operator new(size_t size)
+{
+    void* ptr = allocate(size);
+    if (ptr == nullptr)
+        throw std::bad_alloc();
+
+    return ptr;
+}
+
+template <size_t N>
+void* FixedVector<N>::operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+template <size_t N>
+void FixedVector<N>::operator delete(void* ptr)
+{
+    deallocate(ptr);
+}
+
+template <size_t N>
+double* FixedVector<N>::getMutableData()
+{
+    return coords;
+}
+
+template <size_t N>
+IVector* FixedVector<N>::clone() const
+{
+    auto* copy = new (std::nothrow) FixedVector<N>(coords);
+
+    if (copy == nullptr)
+        log(RC::ALLOCATION_ERROR, __FILE__, __FUNCTION__, __LINE__);
+
+    return copy;
+}
+
+template <size_t N>
+double const* FixedVector<N>::getData() const
+{
+    return coords;
+}
+
+template <size_t N>
+RC FixedVector<N>::setData(size_t dim, double const* const& ptr_data)
+{
+    return setDataOf(coords, N, dim, ptr_data);
+}
+
+template <size_t N>
+size_t FixedVector<N>::getDim() const
+{
+    return N;
+}
+
+template <size_t N>
+size_t FixedVector<N>::sizeAllocated() const
+{
+    return sizeof(*this);
+}
+
+template <size_t N>
+RC FixedVector<N>::getCord(size_t index, double& val) const
+{
+    if (index >= N)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    val = coords[index];
+    return RC::SUCCESS;
+}
+
+template <size_t N>
+RC FixedVector<N>::setCord(size_t index, double val)
+{
+    if (index >= N)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    if (!std::isfinite(val))
+    {
+        log(RC::INVALID_ARGUMENT, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    coords[index] = val;
+    return RC::SUCCESS;
+}
+
+/*
+* Arithmetic computes the result in registers and commits it only if it is finite. Overflow is rare, so then the
+* shared code of the library redoes the operation and applies the overflow checking policy of the thread
+*/
+template <size_t N>
+RC FixedVector<N>::scale(double multiplier)
+{
+    double result[N];
+    bool finite = std::isfinite(multiplier);
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        result[i] = coords[i] * multiplier;
+        finite &= std::isfinite(result[i]);
+    }
+
+    if (!finite)
+        return scaleOf(coords, N, multiplier);
+
+    for (size_t i = 0; i < N; ++i)
+        coords[i] = result[i];
+
+    return RC::SUCCESS;
+}
+
+template <size_t N>
+RC FixedVector<N>::inc(IVector const* const& op)
+{
+    return combine(op, 1.0);
+}
+
+template <size_t N>
+RC FixedVector<N>::dec(IVector const* const& op)
+{
+    return combine(op, -1.0);
+}
+
+template <size_t N>
+RC FixedVector<N>::combine(IVector const* op, double sign)
+{
+    if (op == nullptr || op->getDim() != N)
+        return combineOf(coords, N, op, sign);
+
+    double const* other = op->getData();
+    double result[N];
+    bool finite = true;
+
+    for (size_t i = 0; i < N; ++i)
+    {
+        result[i] = coords[i] + sign * other[i];
+        finite &= std::isfinite(result[i]);
+    }
+
+    if (!finite)
+        return combineOf(coords, N, op, sign);
+
+    for (size_t i = 0; i < N; ++i)
+        coords[i] = result[i];
+
+    return RC::SUCCESS;
+}
+
+template <size_t N>
+double FixedVector<N>::norm(NORM n) const
+{
+    double result = 0;
+
+    switch (n)
+    {
+        case NORM::FIRST:
+            for (size_t i = 0; i < N; ++i)
+                result += std::fabs(coords[i]);
+            break;
+
+        case NORM::SECOND:
+            for (size_t i = 0; i < N; ++i)
+                result += coords[i] * coords[i];
+            result = std::sqrt(result);
+            break;
+
+        case NORM::CHEBYSHEV:
+            for (size_t i = 0; i < N; ++i)
+                result = std::max(result, std::fabs(coords[i]));
+            break;
+
+        default:
+        {
+            log(RC::INVALID_ARGUMENT, __FILE__, __FUNCTION__, __LINE__);
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+    }
+
+    if (!std::isfinite(result))
+    {
+        log(RC::INVALID_ARGUMENT, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return result;
+}
+
+template <size_t N>
+RC FixedVector<N>::applyFunction(const std::function<double(double)>& fun)
+{
+    return applyOf(coords, N, fun);
+}
+
+template <size_t N>
+RC FixedVector<N>::applyBatch(const std::function<void(double* values, size_t count)>& fun)
+{
+    return applyBatchOf(coords, N, fun);
+}
+
+template <size_t N>
+RC FixedVector<N>::foreach(const std::function<void(double)>& fun) const
+{
+    for (size_t i = 0; i < N; ++i)
+        fun(coords[i]);
+
+    return RC::SUCCESS;
+}
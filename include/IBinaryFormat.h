@@ -0,0 +1,109 @@
+#pragma once
+#include <cstddef>
+#include "IVector.h"
+#include "IMultiIndex.h"
+#include "ICompact.h"
+#include "ISet.h"
+#include "IMappedVectorArray.h"
+#include "ILogger.h"
+#include "RC.h"
+#include "Interfacedllexport.h"
+
+/*
+* Versioned binary records of vectors, multi-indices, compacts and sets
+*
+* Record is a 64-byte header followed by the payload in native byte order:
+*
+*     offset  0  magic "IVBF"
+*     offset  4  uint16 version
+*     offset  6  uint16 type
+*     offset  8  uint32 0x01020304, tells the byte order of the writer
+*     offset 16  uint64 dim
+*     offset 24  uint64 count
+*     offset 32  uint64 payload size in bytes, the rest of the header is zeros
+*
+*     VECTOR       dim doubles
+*     MULTI_INDEX  dim uint64
+*     COMPACT      dim doubles of the left boundary, dim doubles of the right one, dim uint64 of the grid
+*     SET          count vectors of dim doubles one after another
+*
+* Payload starts on a cache line of a page-aligned buffer, so coordinates of a record are used right where they lie:
+* getCoords returns them without copying, and files written by save are mapped with mapVector and mapSet
+*/
+class LIB_EXPORT IBinaryFormat {
+public:
+    enum class TYPE {
+        VECTOR = 1,
+        MULTI_INDEX = 2,
+        COMPACT = 3,
+        SET = 4
+    };
+
+    static const unsigned version = 1;
+    static const size_t headerSize = 64;
+
+    struct Header {
+        TYPE type;
+        size_t dim;
+        size_t count;
+    };
+
+    static RC setLogger(ILogger* const logger);
+    static ILogger* getLogger();
+
+    /*
+    * Size of the record in bytes, 0 if the object is nullptr
+    */
+    static size_t getSize(IVector const* const& vec);
+    static size_t getSize(IMultiIndex const* const& index);
+    static size_t getSize(ICompact const* const& compact);
+    static size_t getSize(ISet const* const& set);
+
+    /*
+    * Writes the record to buffer of size bytes, which must be aligned to sizeof(double)
+    */
+    static RC write(IVector const* const& vec, void* buffer, size_t size);
+    static RC write(IMultiIndex const* const& index, void* buffer, size_t size);
+    static RC write(ICompact const* const& compact, void* buffer, size_t size);
+    static RC write(ISet const* const& set, void* buffer, size_t size);
+
+    /*
+    * Writes the record to the file, replacing its contents
+    */
+    static RC save(char const* path, IVector const* const& vec);
+    static RC save(char const* path, IMultiIndex const* const& index);
+    static RC save(char const* path, ICompact const* const& compact);
+    static RC save(char const* path, ISet const* const& set);
+
+    /*
+    * Checks the header and that the whole payload fits in size bytes
+    */
+    static RC readHeader(void const* buffer, size_t size, Header& header);
+    static RC readHeader(char const* path, Header& header);
+
+    /*
+    * Coordinates of a VECTOR or SET record, boundaries of a COMPACT one, right inside buffer. Coordinates are checked
+    * to be finite, nullptr is returned on any error. Wrap them in views, which must not outlive buffer:
+    *
+    *     IVectorView row(header.dim, coords + index * header.dim);
+    */
+    static double const* getCoords(void const* buffer, size_t size, Header& header);
+
+    /*
+    * Readers building owning objects from the record, records with coordinates that are not finite give nullptr
+    */
+    static IVector* readVector(void const* buffer, size_t size);
+    static IMultiIndex* readMultiIndex(void const* buffer, size_t size);
+    static ICompact* readCompact(void const* buffer, size_t size);
+    static ISet* readSet(void const* buffer, size_t size);
+
+    /*
+    * Maps VECTOR or SET record of the file read-only, nothing is copied to the heap. Records without coordinates
+    * give an empty array and an ordinary vector of dimension 0
+    */
+    static IVector* mapVector(char const* path);
+    static IMappedVectorArray* mapSet(char const* path);
+
+private:
+    IBinaryFormat() = delete;
+};
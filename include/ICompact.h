@@ -20,6 +20,16 @@ public:
     */
     virtual RC getVectorCopy(IMultiIndex const *index, IVector *& val) const = 0;
     /*
+    * Same as getVectorCopy, val owns the new IVector and is left empty on failure
+    */
+    RC getVectorCopy(IMultiIndex const *index, VectorPtr & val) const
+    {
+        IVector * copy = nullptr;
+        RC err = getVectorCopy(index, copy);
+        val.reset(copy);
+        return err;
+    }
+    /*
     * Method copy data from vector in ISet to vector val
     */
     virtual RC getVectorCoords(IMultiIndex const *index, IVector * const& val) const = 0;
@@ -28,6 +38,20 @@ public:
     virtual RC getLeftBoundary(IVector *& vec) const = 0;
     // правейшая по всем координатам
     virtual RC getRightBoundary(IVector *& vec) const = 0;
+    RC getLeftBoundary(VectorPtr & vec) const
+    {
+        IVector * copy = nullptr;
+        RC err = getLeftBoundary(copy);
+        vec.reset(copy);
+        return err;
+    }
+    RC getRightBoundary(VectorPtr & vec) const
+    {
+        IVector * copy = nullptr;
+        RC err = getRightBoundary(copy);
+        vec.reset(copy);
+        return err;
+    }
     virtual size_t getDim() const = 0;
     virtual IMultiIndex* getGrid() const = 0;
 
@@ -55,6 +79,13 @@ public:
         * Method creating new IVector and assigning new address to val
         */
         virtual RC getVectorCopy(IVector *& val) const = 0;
+        RC getVectorCopy(VectorPtr & val) const
+        {
+            IVector * copy = nullptr;
+            RC err = getVectorCopy(copy);
+            val.reset(copy);
+            return err;
+        }
         /*
         * Method copy data from vector in ISet to vector val
         */
@@ -0,0 +1,67 @@
+#pragma once
+#include <cstddef>
+#include "IVector.h"
+#include "RC.h"
+#include "Interfacedllexport.h"
+
+/*
+* Vector with single precision coordinates
+*
+* Storage takes half the memory of IVector, so scans over large point clouds read half the bytes. Coordinates are
+* widened to double before any arithmetic: norms, products and distances are accumulated in double precision and
+* match the results of IVector computed over the same (rounded) coordinates
+*/
+class LIB_EXPORT IFloatVector {
+public:
+    static IFloatVector* createVector(size_t dim, float const* const& ptr_data);
+    /*
+    * Rounds coordinates of vec to the nearest floats, returns nullptr if some coordinate is out of float range
+    */
+    static IFloatVector* createVector(IVector const* const& vec);
+    static RC setLogger(ILogger* const logger);
+    static ILogger* getLogger();
+
+    virtual IFloatVector* clone() const = 0;
+    /*
+    * Double precision copy, the conversion is exact
+    */
+    virtual IVector* toVector() const = 0;
+    /*
+    * Rounds coordinates of vec to the nearest floats, vector is left unchanged if some of them is out of float range
+    */
+    virtual RC assign(IVector const* const& vec) = 0;
+
+    virtual float const* getData() const = 0;
+    virtual RC setData(size_t dim, float const* const& ptr_data) = 0;
+
+    virtual RC getCord(size_t index, double& val) const = 0;
+    virtual RC setCord(size_t index, double val) = 0;
+    virtual size_t getDim() const = 0;
+
+    /*
+    * Arithmetic is done in double and rounded once, result out of float range fails with RC::INFINITY_OVERFLOW
+    */
+    virtual RC scale(double multiplier) = 0;
+    virtual RC inc(IFloatVector const* const& op) = 0;
+    virtual RC dec(IFloatVector const* const& op) = 0;
+
+    virtual double norm(IVector::NORM n) const = 0;
+
+    static double dot(IFloatVector const* const& op1, IFloatVector const* const& op2);
+    /*
+    * Mixed precision product of float and double coordinates
+    */
+    static double dot(IFloatVector const* const& op1, IVector const* const& op2);
+    static double distance(IFloatVector const* const& op1, IFloatVector const* const& op2, IVector::NORM n);
+
+    virtual size_t sizeAllocated() const = 0;
+
+    virtual ~IFloatVector() = 0;
+
+private:
+    IFloatVector(const IFloatVector& vector) = delete;
+    IFloatVector& operator=(const IFloatVector& vector) = delete;
+
+protected:
+    IFloatVector() = default;
+};
@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include "IVector.h"
+#include "ILogger.h"
+#include "RC.h"
+#include "Interfacedllexport.h"
+
+/*
+* Vectors stored in a memory-mapped file
+*
+* File holds raw doubles in native byte order, count vectors of dimension dim lie one after another starting at the
+* given byte offset, which must be a multiple of sizeof(double). Coordinates are used right where they are mapped,
+* nothing is read into the heap or copied, so even huge vectors are ready as soon as the file is mapped.
+* Coordinates are checked to be finite when the file is mapped
+*
+* Single vector from createVector is an ordinary IVector owning its mapping. Vectors of an array are accessed
+* through views, which must not outlive the array:
+*
+*     IVectorView row(array->getDim(), array->getData(index));
+*/
+class LIB_EXPORT IMappedVectorArray {
+public:
+    enum class MODE {
+        READ_ONLY,  // existing file is mapped privately, vectors behave like IVectorView
+        READ_WRITE  // file is created or extended with zeros when needed, changes go straight to it
+    };
+
+    static RC setLogger(ILogger* const logger);
+    static ILogger* getLogger();
+
+    static IMappedVectorArray* createArray(char const* path, size_t dim, size_t count, MODE mode, size_t offset = 0);
+    /*
+    * READ_ONLY vector fails to change its coordinates like IVectorView, READ_WRITE one behaves like IMutableVectorView
+    */
+    static IVector* createVector(char const* path, size_t dim, MODE mode, size_t offset = 0);
+
+    virtual size_t getDim() const = 0;
+    virtual size_t getSize() const = 0;
+    virtual MODE getMode() const = 0;
+
+    /*
+    * Coordinates of the vector with the index inside the mapping or nullptr if the index is out of range
+    */
+    virtual double const* getData(size_t index) const = 0;
+    /*
+    * Same as getData for READ_WRITE arrays, nullptr for READ_ONLY ones. Written coordinates must be finite
+    */
+    virtual double* getMutableData(size_t index) = 0;
+
+    virtual RC getCoords(size_t index, IVector* const& val) const = 0;
+    virtual RC setCoords(size_t index, IVector const* const& val) = 0;
+
+    /*
+    * Writes changed pages of a READ_WRITE array to the disk and waits for it
+    */
+    virtual RC flush() = 0;
+
+    virtual ~IMappedVectorArray() = 0;
+
+private:
+    IMappedVectorArray(const IMappedVectorArray& array) = delete;
+    IMappedVectorArray& operator=(const IMappedVectorArray& array) = delete;
+
+protected:
+    IMappedVectorArray() = default;
+};
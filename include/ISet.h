@@ -4,30 +4,83 @@
 #include "RC.h"
 #include "Interfacedllexport.h"
 
+class IVectorBatch;
+
 class LIB_EXPORT ISet {
 public:
     static RC setLogger(ILogger* const logger);
     static ILogger* getLogger();
 
     static ISet* createSet();
+    /*
+    * Set hashing its vectors into cells of side tol, meant for deduplication with the fixed metric n and tol, which
+    * insert and findFirst use when they are called without a metric
+    *
+    * insert and findFirst methods with any NORM and a tolerance not greater than tol probe only the cells around
+    * the pattern, which takes O(1) on average instead of a search. Larger tolerances fall back to a scan. Cells are
+    * used up to dimension 6, beyond it the set keeps its usual index
+    */
+    static ISet* createSet(IVector::NORM n, double tol);
     virtual ISet* clone() const = 0;
 
-    static ISet* makeIntersection(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
-    static ISet* makeUnion(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
-    static ISet* sub(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
-    static ISet* symSub(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
+    /*
+    * How set operations run: PARALLEL splits the lookups of the probe set among the threads of
+    * IVector::setThreadCount, the result is the same as the SEQUENTIAL one, in the same order
+    */
+    enum class EXECUTION {
+        SEQUENTIAL,
+        PARALLEL
+    };
+
+    static ISet* makeIntersection(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol,
+                                  EXECUTION execution = EXECUTION::SEQUENTIAL);
+    static ISet* makeUnion(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol,
+                           EXECUTION execution = EXECUTION::SEQUENTIAL);
+    static ISet* sub(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol,
+                     EXECUTION execution = EXECUTION::SEQUENTIAL);
+    static ISet* symSub(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol,
+                        EXECUTION execution = EXECUTION::SEQUENTIAL);
 
-    static bool equals(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
-    static bool subSet(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol);
+    static bool equals(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol,
+                       EXECUTION execution = EXECUTION::SEQUENTIAL);
+    static bool subSet(ISet const * const& op1, ISet const * const& op2, IVector::NORM n, double tol,
+                       EXECUTION execution = EXECUTION::SEQUENTIAL);
 
     virtual size_t getDim() const = 0;
     virtual size_t getSize() const = 0;
 
+    /*
+    * Vectors are stored in fixed-size aligned chunks, growth allocates new chunks and never moves stored vectors
+    *
+    * reserve makes room for count vectors in total, an empty set makes it once the first vector gives the dimension.
+    * hugePages asks for 2 MiB chunks backed by huge pages where the system supports it, which is possible only while
+    * the set has no chunks, false leaves the chunks as they are. shrinkToFit frees the chunks past the last vector
+    */
+    virtual RC reserve(size_t count, bool hugePages = false) = 0;
+    virtual RC shrinkToFit() = 0;
+
     /*
      * Method creating new IVector and assigning new address to val
      */
     virtual RC getCopy(size_t index, IVector *& val) const = 0;
     virtual RC findFirstAndCopy(IVector const * const& pat, IVector::NORM n, double tol, IVector *& val) const = 0;
+    /*
+     * Same methods handing the new IVector over to val, which is left empty on failure
+     */
+    RC getCopy(size_t index, VectorPtr & val) const
+    {
+        IVector * copy = nullptr;
+        RC err = getCopy(index, copy);
+        val.reset(copy);
+        return err;
+    }
+    RC findFirstAndCopy(IVector const * const& pat, IVector::NORM n, double tol, VectorPtr & val) const
+    {
+        IVector * copy = nullptr;
+        RC err = findFirstAndCopy(pat, n, tol, copy);
+        val.reset(copy);
+        return err;
+    }
 
     /*
      * Method copy data from vector in ISet to vector val
@@ -37,6 +90,22 @@ public:
     virtual RC findFirst(IVector const * const& pat, IVector::NORM n, double tol) const = 0;
 
     virtual RC insert(IVector const * const& val, IVector::NORM n, double tol) = 0;
+    /*
+    * Same methods with the metric the set was created with, sets made by createSet() look for exact duplicates
+    * (CHEBYSHEV and 0)
+    */
+    virtual RC findFirst(IVector const * const& pat) const = 0;
+    virtual RC insert(IVector const * const& val) = 0;
+    /*
+    * Inserts count vectors of dimension dim stored in rows one after another, as insert would one by one: a row
+    * within tol of a vector of the set or of an earlier row of the batch is skipped. Storage grows once for the batch
+    *
+    * Code of every row goes to statuses if it is given, rows which are not finite are skipped with NOT_NUMBER or
+    * INFINITY_OVERFLOW. Returns the code of the first skipped row, SUCCESS if all were inserted
+    */
+    virtual RC insertBatch(double const * rows, size_t dim, size_t count, IVector::NORM n, double tol,
+                           RC * statuses = nullptr) = 0;
+    RC insertBatch(IVectorBatch const * const& batch, IVector::NORM n, double tol, RC * statuses = nullptr);
 
     virtual RC remove(size_t index) = 0;
     virtual RC remove(IVector const * const& pat, IVector::NORM n, double tol) = 0;
@@ -73,6 +142,13 @@ public:
         * Getter of value (same semantic as ISet::getCopy)
         */
         virtual RC getVectorCopy(IVector *& val) const = 0;
+        RC getVectorCopy(VectorPtr & val) const
+        {
+            IVector * copy = nullptr;
+            RC err = getVectorCopy(copy);
+            val.reset(copy);
+            return err;
+        }
         /*
         * Getter of value (same semantic as ISet::getCoords)
         */
@@ -26,6 +26,16 @@ public:
     virtual RC solveByArgs(IVector const* const& initArg, IVector const* const& solverParams) = 0;
     virtual RC solveByParams(IVector const* const& initParam, IVector const* const& solverParams) = 0;
     virtual RC getSolution(IVector*& solution) const = 0;
+    /*
+    * Hands the solution over to an owning handle, which is left empty on failure
+    */
+    RC getSolution(VectorPtr& solution) const
+    {
+        IVector* copy = nullptr;
+        RC err = getSolution(copy);
+        solution.reset(copy);
+        return err;
+    }
 
     virtual ~ISolver() = 0;
 
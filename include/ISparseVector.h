@@ -0,0 +1,72 @@
+#pragma once
+#include <cstddef>
+#include "IVector.h"
+#include "ILogger.h"
+#include "RC.h"
+#include "Interfacedllexport.h"
+
+/*
+* Vector which stores only its nonzero coordinates
+*
+* Nonzeros are kept as two parallel arrays ordered by index, so memory and the cost of dot products, norms and axpy
+* into a dense vector are O(nnz) instead of O(dim). Zero coordinates are never stored: a coordinate set to zero is
+* removed and createVector drops zero values
+*/
+class LIB_EXPORT ISparseVector {
+public:
+    /*
+    * indices must be strictly increasing and less than dim, values must be finite
+    */
+    static ISparseVector* createVector(size_t dim, size_t nnz, size_t const* indices, double const* values);
+    /*
+    * Keeps the nonzero coordinates of vec
+    */
+    static ISparseVector* createVector(IVector const* const& vec);
+    static RC setLogger(ILogger* const logger);
+    static ILogger* getLogger();
+
+    virtual ISparseVector* clone() const = 0;
+    /*
+    * Dense copy
+    */
+    virtual IVector* toVector() const = 0;
+
+    virtual size_t getDim() const = 0;
+    virtual size_t getNonZeroCount() const = 0;
+    /*
+    * Indices and values of the nonzero coordinates, getNonZeroCount() of each, valid until the vector is changed
+    */
+    virtual size_t const* getIndices() const = 0;
+    virtual double const* getValues() const = 0;
+
+    /*
+    * Binary search over the nonzeros, O(log nnz) to read, O(nnz) to insert a new nonzero or remove one
+    */
+    virtual RC getCord(size_t index, double& val) const = 0;
+    virtual RC setCord(size_t index, double val) = 0;
+
+    virtual RC scale(double multiplier) = 0;
+    virtual double norm(IVector::NORM n) const = 0;
+
+    static double dot(ISparseVector const* const& op1, IVector const* const& op2);
+    /*
+    * Merge of the two index lists, O(nnz1 + nnz2)
+    */
+    static double dot(ISparseVector const* const& op1, ISparseVector const* const& op2);
+    /*
+    * dest += multiplier * op, touches only the nonzero coordinates of op and follows the overflow check policy of
+    * the calling thread like IVector::inc
+    */
+    static RC axpy(IVector* const dest, double multiplier, ISparseVector const* const& op);
+
+    virtual size_t sizeAllocated() const = 0;
+
+    virtual ~ISparseVector() = 0;
+
+private:
+    ISparseVector(const ISparseVector& vector) = delete;
+    ISparseVector& operator=(const ISparseVector& vector) = delete;
+
+protected:
+    ISparseVector() = default;
+};
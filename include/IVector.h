@@ -1,10 +1,32 @@
 #pragma once
 #include <cstddef>
 #include <functional>
+#include <memory>
 #include "RC.h"
 #include "ILogger.h"
 #include "Interfacedllexport.h"
 
+class IVector;
+
+/*
+* Deleter of VectorPtr, the vector is destroyed inside the library, so its memory goes back to the vector pool
+* (or arena) it came from
+*/
+struct LIB_EXPORT VectorDeleter {
+    void operator()(IVector* vector) const;
+};
+
+/*
+* Move-only owning handle of a vector
+*
+* Factories returning VectorPtr are counterparts of the ones returning raw pointers, an empty handle means failure.
+* A handle is released automatically on every return path, and it is passed along by std::move instead of cloning:
+*
+*     VectorPtr x = IVector::createVectorPtr(dim, data);
+*     set->getCopy(index, x);
+*/
+using VectorPtr = std::unique_ptr<IVector, VectorDeleter>;
+
 class LIB_EXPORT IVector {
 public:
     enum class NORM {
@@ -14,11 +36,83 @@ public:
         AMOUNT
     };
 
+    /*
+    * Overflow checking policy of arithmetic methods (inc, dec, scale, applyFunction, applyBatch, add, sub) and of
+    * IVectorBatch::axpy
+    *
+    * Policy is set separately for every thread, EAGER is used by default
+    *
+    * EAGER - result is validated before it is written, destination is never changed on overflow. In-place methods
+    * (inc, dec, scale) read their operands twice for that, DEFERRED policies make a single pass
+    *
+    * DEFERRED - method makes a single unchecked pass, overflow is detected afterwards from floating-point
+    * exception flags (or one vectorized reduction for applyFunction). Method still returns RC::INFINITY_OVERFLOW,
+    * but destination keeps the overflowed coordinates. Operands are expected to be finite
+    *
+    * DEFERRED_ROLLBACK - same as DEFERRED, but destination is copied before the pass and restored on overflow
+    */
+    enum class OVERFLOW_CHECK {
+        EAGER,
+        DEFERRED,
+        DEFERRED_ROLLBACK
+    };
+
+    /*
+    * Built-in elementwise functions of applyFunction, computed by vectorized kernels
+    *
+    * SIGMOID is 1 / (1 + exp(-x))
+    */
+    enum class FUNCTION {
+        ABS,
+        SQRT,
+        EXP,
+        LOG,
+        SIGMOID
+    };
+
+    /*
+    * Statistics of the pooled allocator behind createVector, clone, add and sub
+    */
+    struct PoolStats {
+        size_t allocations;       // blocks handed out
+        size_t deallocations;     // blocks given back
+        size_t poolHits;          // allocations served from free lists without calling the system allocator
+        size_t systemAllocations; // allocations that reached the system allocator
+        size_t bytesInUse;        // bytes held by alive vectors
+        size_t bytesCached;       // bytes kept in free lists of all threads and the shared depot
+    };
+
+    /*
+    * Scoped region allocator for temporary vectors
+    *
+    * While an arena is alive, createVector, clone, add and sub called on the same thread take memory from its
+    * bump-pointer regions, and all of it is freed at once when the arena is destroyed. Deleting such a vector
+    * costs nothing (the latest one is given back to the arena, so create-delete loops reuse the same memory).
+    * Arenas nest, the innermost one is used. Vectors must not outlive their arena, and an arena must be destroyed
+    * on the thread which created it
+    */
+    class LIB_EXPORT Arena {
+    public:
+        explicit Arena(size_t regionSize = 64 * 1024);
+        ~Arena();
+
+        // Bytes currently taken from the regions, including block headers
+        size_t bytesUsed() const;
+
+    private:
+        Arena(const Arena& arena) = delete;
+        Arena& operator=(const Arena& arena) = delete;
+
+        void* state; // nullptr if the arena could not be allocated, vectors then come from the pool
+    };
+
     static IVector* createVector(size_t dim, double const* const& ptr_data);
+    static VectorPtr createVectorPtr(size_t dim, double const* const& ptr_data);
     static RC copyInstance(IVector* const dest, IVector const* const& src);
     static RC moveInstance(IVector* const dest, IVector*& src);
 
     virtual IVector* clone() const = 0;
+    VectorPtr clonePtr() const;
     virtual double const* getData() const = 0;
     // Dim needs for double check that ptr_data have the same size as dimension of vector
     virtual RC setData(size_t dim, double const* const& ptr_data) = 0;
@@ -26,6 +120,36 @@ public:
     static RC setLogger(ILogger* const logger);
     static ILogger* getLogger();
 
+    static RC setOverflowCheck(OVERFLOW_CHECK check);
+    static OVERFLOW_CHECK getOverflowCheck();
+    /*
+    * Checks a whole batch of deferred operations at once
+    *
+    * Returns RC::INFINITY_OVERFLOW if any method called on this thread with deferred policy has overflowed
+    * since the previous call, RC::SUCCESS otherwise
+    */
+    static RC checkDeferredOverflow();
+
+    /*
+    * dot and norm of vectors with at least threshold coordinates are computed by several threads
+    *
+    * Coordinates are split into chunks of fixed size and the partial results are combined in fixed order, so the
+    * result does not depend on the number of threads. Default threshold is 1 << 20 coordinates
+    */
+    static RC setParallelThreshold(size_t threshold);
+    static size_t getParallelThreshold();
+    /*
+    * Number of threads taking part in parallel computations, including the calling one. 0 (default) means one thread
+    * per hardware thread
+    */
+    static RC setThreadCount(size_t count);
+
+    static RC getPoolStats(PoolStats& stats);
+    /*
+    * Gives memory cached by the calling thread and the shared depot back to the system
+    */
+    static RC releasePool();
+
     virtual RC getCord(size_t index, double& val) const = 0;
     virtual RC setCord(size_t index, double val) = 0;
     virtual RC scale(double multiplier) = 0;
@@ -36,14 +160,73 @@ public:
 
     static IVector* add(IVector const* const& op1, IVector const* const& op2);
     static IVector* sub(IVector const* const& op1, IVector const* const& op2);
+    static VectorPtr addPtr(IVector const* const& op1, IVector const* const& op2);
+    static VectorPtr subPtr(IVector const* const& op1, IVector const* const& op2);
+
+    /*
+    * dest = coefs[0] * ops[0] + ... + coefs[count - 1] * ops[count - 1]
+    *
+    * Every coordinate is computed in one fused pass and the whole result is checked for overflow once, according to
+    * the overflow checking policy. dest may be one of ops. Expressions of IVectorExpr.h are evaluated through it
+    */
+    static RC linearCombination(IVector* const dest, size_t count, double const* coefs, IVector const* const* ops);
+    static IVector* createLinearCombination(size_t count, double const* coefs, IVector const* const* ops);
+    static VectorPtr createLinearCombinationPtr(size_t count, double const* coefs, IVector const* const* ops);
 
     static double dot(IVector const* const& op1, IVector const* const& op2);
+    /*
+    * Norm of op1 - op2, computed without creating the difference vector. Returns NaN on error
+    */
+    static double distance(IVector const* const& op1, IVector const* const& op2, NORM n);
+    /*
+    * Tells whether distance(op1, op2, n) <= tol, stops as soon as the partial norm exceeds tol
+    */
+    static bool withinTolerance(IVector const* const& op1, IVector const* const& op2, NORM n, double tol);
     static bool equals(IVector const* const& op1, IVector const* const& op2, NORM n, double tol);
     virtual double norm(NORM n) const = 0;
 
     virtual RC applyFunction(const std::function<double(double)>& fun) = 0;
     virtual RC foreach(const std::function<void(double)>& fun) const = 0;
 
+    /*
+    * Calls fun once with all coordinates, which it rewrites in place, so fun may run its own vectorized loop.
+    * Result is checked according to the overflow checking policy, under EAGER fun is given a copy of the
+    * coordinates, which is written back only if it is finite
+    */
+    virtual RC applyBatch(const std::function<void(double* values, size_t count)>& fun);
+
+    /*
+    * Same as the std::function overloads, but fun is called directly and can be inlined into the loop
+    */
+    template <class Fun>
+    RC applyFunction(const Fun& fun)
+    {
+        return applyBatch([&fun](double* values, size_t count) {
+            for (size_t i = 0; i < count; ++i)
+                values[i] = fun(values[i]);
+        });
+    }
+
+    template <class Fun>
+    RC foreach(const Fun& fun) const
+    {
+        double const* values = getData();
+        const size_t count = getDim();
+        for (size_t i = 0; i < count; ++i)
+            fun(values[i]);
+
+        return RC::SUCCESS;
+    }
+
+    /*
+    * Arguments outside of the domain of SQRT and LOG give RC::INFINITY_OVERFLOW, as any other non-finite result
+    */
+    RC applyFunction(FUNCTION fun);
+    /*
+    * Clamps every coordinate to [lower, upper]
+    */
+    RC clamp(double lower, double upper);
+
     virtual size_t sizeAllocated() const = 0;
 
     virtual ~IVector() = 0;
@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include "IVector.h"
+#include "RC.h"
+#include "Interfacedllexport.h"
+
+/*
+* Fixed number of vectors of the same dimension stored in one contiguous aligned block
+*
+* Storage is structure of arrays: coordinates of one axis of all vectors lie next to each other, so batched operations
+* run vectorized kernels over long columns instead of making virtual calls per vector
+*/
+class LIB_EXPORT IVectorBatch {
+public:
+    static RC setLogger(ILogger* const logger);
+    static ILogger* getLogger();
+
+    /*
+    * Batch of count zero vectors
+    */
+    static IVectorBatch* createBatch(size_t dim, size_t count);
+    /*
+    * Batch of count vectors, whose coordinates are stored in rows one after another
+    */
+    static IVectorBatch* createBatch(size_t dim, size_t count, double const* const& rows);
+    virtual IVectorBatch* clone() const = 0;
+
+    virtual size_t getDim() const = 0;
+    virtual size_t getSize() const = 0;
+
+    /*
+    * Method copy coordinates of vector with the index to val
+    */
+    virtual RC getCoords(size_t index, IVector* const& val) const = 0;
+    virtual RC setCoords(size_t index, IVector const* const& val) = 0;
+    /*
+    * Coordinates of all vectors along the axis, getColumn(axis)[index] belongs to the vector with the index
+    */
+    virtual double const* getColumn(size_t axis) const = 0;
+
+    /*
+    * Batched methods write one value per vector to result, which must hold getSize() values
+    */
+    virtual RC norms(IVector::NORM n, double* result) const = 0;
+    virtual RC dots(IVector const* const& query, double* result) const = 0;
+    virtual RC distances(IVector const* const& query, IVector::NORM n, double* result) const = 0;
+    /*
+    * Adds multiplier * op to every vector. Overflow is handled by the overflow checking policy of the thread, as in
+    * IVector arithmetic
+    */
+    virtual RC axpy(double multiplier, IVector const* const& op) = 0;
+    /*
+    * result[i * getSize() + j] is the distance between vectors i and j, result must hold getSize() * getSize() values
+    */
+    virtual RC pairwiseDistances(IVector::NORM n, double* result) const = 0;
+
+    virtual ~IVectorBatch() = 0;
+
+private:
+    IVectorBatch(const IVectorBatch& batch) = delete;
+    IVectorBatch& operator=(const IVectorBatch& batch) = delete;
+
+protected:
+    IVectorBatch() = default;
+};
@@ -0,0 +1,102 @@
+#pragma once
+#include <cstddef>
+#include "RC.h"
+#include "IVector.h"
+
+/*
+* Lazy linear combinations of vectors
+*
+* Arithmetic on terms only collects coefficients and operands, nothing is computed until the expression is evaluated.
+* Then every coordinate is computed in one fused pass by IVector::linearCombination, so a line search step reuses its
+* destination and creates no temporary vectors:
+*
+*     (VectorExpr::term(x) + t * VectorExpr::term(d)).evaluate(point);
+*     IVector* r = (a * VectorExpr::term(x) + b * VectorExpr::term(y) - z).create();
+*/
+namespace VectorExpr
+{
+    template <size_t N>
+    class LinearCombination
+    {
+    public:
+        double coefs[N];
+        IVector const* ops[N];
+
+        /*
+        * Writes the combination to dest, which may be one of its operands
+        */
+        RC evaluate(IVector* const dest) const
+        {
+            return IVector::linearCombination(dest, N, coefs, ops);
+        }
+
+        /*
+        * Returns new vector holding the combination or nullptr
+        */
+        IVector* create() const
+        {
+            return IVector::createLinearCombination(N, coefs, ops);
+        }
+    };
+
+    inline LinearCombination<1> term(IVector const* op)
+    {
+        return {{1.0}, {op}};
+    }
+
+    template <size_t N>
+    LinearCombination<N> operator*(double multiplier, const LinearCombination<N>& expr)
+    {
+        LinearCombination<N> result = expr;
+        for (size_t t = 0; t < N; ++t)
+            result.coefs[t] *= multiplier;
+        return result;
+    }
+
+    template <size_t N>
+    LinearCombination<N> operator*(const LinearCombination<N>& expr, double multiplier)
+    {
+        return multiplier * expr;
+    }
+
+    template <size_t N>
+    LinearCombination<N> operator-(const LinearCombination<N>& expr)
+    {
+        return -1.0 * expr;
+    }
+
+    template <size_t N, size_t M>
+    LinearCombination<N + M> operator+(const LinearCombination<N>& lhs, const LinearCombination<M>& rhs)
+    {
+        LinearCombination<N + M> result;
+        for (size_t t = 0; t < N; ++t)
+        {
+            result.coefs[t] = lhs.coefs[t];
+            result.ops[t] = lhs.ops[t];
+        }
+        for (size_t t = 0; t < M; ++t)
+        {
+            result.coefs[N + t] = rhs.coefs[t];
+            result.ops[N + t] = rhs.ops[t];
+        }
+        return result;
+    }
+
+    template <size_t N, size_t M>
+    LinearCombination<N + M> operator-(const LinearCombination<N>& lhs, const LinearCombination<M>& rhs)
+    {
+        return lhs + -1.0 * rhs;
+    }
+
+    template <size_t N>
+    LinearCombination<N + 1> operator+(const LinearCombination<N>& lhs, IVector const* rhs)
+    {
+        return lhs + term(rhs);
+    }
+
+    template <size_t N>
+    LinearCombination<N + 1> operator-(const LinearCombination<N>& lhs, IVector const* rhs)
+    {
+        return lhs - term(rhs);
+    }
+}
@@ -0,0 +1,79 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include "RC.h"
+#include "IVector.h"
+#include "Interfacedllexport.h"
+
+/*
+* Non-owning vector over a borrowed buffer of dim doubles
+*
+* View neither copies nor frees the buffer, so it is as cheap as a pointer and may live on the stack. It can be passed
+* to every method taking IVector const*, the buffer must outlive the view. Methods changing coordinates fail with
+* RC::INVALID_ARGUMENT, clone() returns an ordinary owning vector. A view must not be passed to moveInstance as src
+*/
+class LIB_EXPORT IVectorView : public IVector {
+public:
+    IVectorView(size_t dim, double const* ptr_data);
+
+    /*
+    * Points the view to another buffer of the same dimension, e.g. to the next row of a matrix
+    */
+    RC rebind(double const* ptr_data);
+
+    IVector* clone() const override;
+    double const* getData() const override;
+    RC setData(size_t dim, double const* const& ptr_data) override;
+
+    RC getCord(size_t index, double& val) const override;
+    RC setCord(size_t index, double val) override;
+    RC scale(double multiplier) override;
+    size_t getDim() const override;
+
+    RC inc(IVector const* const& op) override;
+    RC dec(IVector const* const& op) override;
+
+    double norm(NORM n) const override;
+
+    using IVector::applyFunction;
+    using IVector::foreach;
+
+    RC applyFunction(const std::function<double(double)>& fun) override;
+    RC foreach(const std::function<void(double)>& fun) const override;
+    RC applyBatch(const std::function<void(double* values, size_t count)>& fun) override;
+
+    size_t sizeAllocated() const override;
+
+    ~IVectorView() override;
+
+protected:
+    double const* data;
+    size_t dim;
+};
+
+/*
+* View which writes through to the borrowed buffer
+*
+* Arithmetic follows the overflow checking policy of the calling thread, just like for owning vectors
+*/
+class LIB_EXPORT IMutableVectorView : public IVectorView {
+public:
+    IMutableVectorView(size_t dim, double* ptr_data);
+
+    RC rebind(double* ptr_data);
+    double* getMutableData() const;
+
+    RC setData(size_t dim, double const* const& ptr_data) override;
+    RC setCord(size_t index, double val) override;
+    RC scale(double multiplier) override;
+
+    RC inc(IVector const* const& op) override;
+    RC dec(IVector const* const& op) override;
+
+    using IVector::applyFunction;
+
+    RC applyFunction(const std::function<double(double)>& fun) override;
+    RC applyBatch(const std::function<void(double* values, size_t count)>& fun) override;
+
+    ~IMutableVectorView() override;
+};
@@ -17,7 +17,7 @@ public:
     class Iterator : public IIterator
     {
     public:
-        Iterator(IVector* iVector_, IMultiIndex* index_, IMultiIndex* bypassOrder_, const std::shared_ptr<CompactControlBlockImpl>& pBlock_);
+        Iterator(VectorPtr iVector_, IMultiIndex* index_, IMultiIndex* bypassOrder_, const std::shared_ptr<CompactControlBlockImpl>& pBlock_);
 
         IIterator* getNext() override;
 
@@ -38,7 +38,7 @@ public:
         ~Iterator() override;
 
     private:
-        IVector* iVector;
+        VectorPtr iVector;
         IMultiIndex* index;
         IMultiIndex* bypassOrder;
         std::shared_ptr<CompactControlBlockImpl> pBlock;
@@ -51,6 +51,7 @@ public:
 
     bool isInside(const IVector* const& vec) const override;
 
+    using ICompact::getVectorCopy;
     RC getVectorCopy(const IMultiIndex* index, IVector*& val) const override;
 
     RC getVectorCoords(const IMultiIndex* index, IVector* const& val) const override;
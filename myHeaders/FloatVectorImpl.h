@@ -0,0 +1,58 @@
+#pragma once
+#include "../include/IFloatVector.h"
+
+class FloatVectorImpl : public IFloatVector
+{
+public:
+    static RC setLogger(ILogger* const pLogger);
+    static ILogger* getLogger();
+    static void log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line);
+
+    /*
+    * Coordinates start on a cache line and are followed by zeros up to a multiple of simdWidth,
+    * returns vector with uninitialized coordinates or nullptr
+    */
+    static const size_t simdWidth = 16;
+    static FloatVectorImpl* allocate(size_t dim);
+
+    /*
+    * Rounds double coordinates to floats, fails without writing anything if some of them is out of float range
+    */
+    static RC narrow(float* dst, double const* src, size_t dim);
+
+    IFloatVector* clone() const override;
+    IVector* toVector() const override;
+    RC assign(IVector const* const& vec) override;
+
+    float const* getData() const override;
+    RC setData(size_t dim, float const* const& ptr_data) override;
+
+    RC getCord(size_t index, double& val) const override;
+    RC setCord(size_t index, double val) override;
+    size_t getDim() const override;
+
+    RC scale(double multiplier) override;
+    RC inc(IFloatVector const* const& op) override;
+    RC dec(IFloatVector const* const& op) override;
+
+    double norm(IVector::NORM n) const override;
+
+    size_t sizeAllocated() const override;
+
+    ~FloatVectorImpl() override;
+
+    // Instances live in blocks of VectorPool
+    static void operator delete(void* ptr);
+
+private:
+    explicit FloatVectorImpl(size_t dim);
+
+    static size_t dataOffset();
+    static size_t paddedDim(size_t dim);
+
+    float* data();
+    RC combine(IFloatVector const* op, double sign);
+
+    static ILogger* logger;
+    size_t dimension;
+};
@@ -0,0 +1,95 @@
+#pragma once
+#include <cstddef>
+#include "../include/IMappedVectorArray.h"
+#include "../include/IVectorView.h"
+
+/*
+* Mapping of a byte range of a file, unmapped and closed in the destructor
+*/
+class FileMapping
+{
+public:
+    /*
+    * Maps bytes of the file starting at offset, writable mapping is shared and grows the file when it is too short.
+    * Returns nullptr and the reason in err on failure
+    */
+    static FileMapping* create(char const* path, size_t offset, size_t bytes, bool writable, RC& err);
+
+    void* data() const;
+    RC flush();
+
+    ~FileMapping();
+
+private:
+    FileMapping(void* base, size_t length, size_t shift, void* file, void* mapping);
+    FileMapping(const FileMapping& mapping) = delete;
+    FileMapping& operator=(const FileMapping& mapping) = delete;
+
+    void* base;     // start of the mapping, aligned down to the allocation granularity
+    size_t length;  // length of the mapping from base
+    size_t shift;   // distance from base to the requested offset
+    void* file;     // handles of the file and the mapping object on Windows, unused elsewhere
+    void* mapping;
+};
+
+class MappedVectorArrayImpl : public IMappedVectorArray
+{
+public:
+    static RC setLogger(ILogger* const pLogger);
+    static ILogger* getLogger();
+    static void log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line);
+
+    /*
+    * Maps count * dim doubles and checks that they are finite, returns nullptr and the reason in err on failure
+    */
+    static FileMapping* map(char const* path, size_t dim, size_t count, MODE mode, size_t offset, RC& err);
+
+    /*
+    * Array takes the mapping over, empty array has none
+    */
+    MappedVectorArrayImpl(size_t dim, size_t count, MODE mode, FileMapping* mapping);
+
+    size_t getDim() const override;
+    size_t getSize() const override;
+    MODE getMode() const override;
+
+    double const* getData(size_t index) const override;
+    double* getMutableData(size_t index) override;
+
+    RC getCoords(size_t index, IVector* const& val) const override;
+    RC setCoords(size_t index, IVector const* const& val) override;
+
+    RC flush() override;
+
+    ~MappedVectorArrayImpl() override;
+
+private:
+    static ILogger* logger;
+    size_t dim;
+    size_t count;
+    MODE mode;
+    FileMapping* mapping;
+};
+
+/*
+* Single mapped vectors, views which own the mapping they point to
+*/
+class MappedVectorView : public IVectorView
+{
+public:
+    MappedVectorView(size_t dim, FileMapping* mapping);
+    ~MappedVectorView() override;
+
+private:
+    FileMapping* mapping;
+};
+
+class MappedMutableVectorView : public IMutableVectorView
+{
+public:
+    MappedMutableVectorView(size_t dim, FileMapping* mapping);
+    ~MappedMutableVectorView() override;
+
+private:
+    FileMapping* mapping;
+};
@@ -0,0 +1,45 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/*
+* Tombstones of the rows of a set
+*
+* Removed rows keep their place until the storage is compacted, a Fenwick tree over the live flags turns the position
+* of a live row among the live ones into its row number and back in O(log n), or in O(1) while nothing is removed
+*/
+class RowRanks
+{
+public:
+    /*
+    * Forgets all rows and makes rows [0, count) live
+    */
+    void reset(size_t count);
+    /*
+    * Appends a live row after the last one
+    */
+    void append();
+    /*
+    * Marks the live row as removed
+    */
+    void erase(size_t row);
+
+    bool isLive(size_t row) const;
+    size_t rows() const;
+    size_t live() const;
+    size_t removed() const;
+
+    /*
+    * Number of live rows before the row
+    */
+    size_t rank(size_t row) const;
+    /*
+    * Row number of the live row at the position, which must be less than live()
+    */
+    size_t select(size_t position) const;
+
+private:
+    std::vector<char> flags;
+    std::vector<size_t> tree; // tree[i] counts live rows in (i - lowbit(i), i], 1-based
+    size_t liveCount = 0;
+};
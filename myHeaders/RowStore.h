@@ -0,0 +1,66 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+
+/*
+* Rows of a set kept in fixed-size aligned chunks
+*
+* Chunk holds a power of two rows, so a row is found by a shift and a mask. Growth allocates new chunks and never
+* moves the rows already stored, their addresses stay valid until the rows are moved by the set or the chunks are
+* freed by shrinkToFit. With huge pages chunks take 2 MiB and are advised to be backed by huge pages where the system
+* supports it
+*/
+class RowStore
+{
+public:
+    static const size_t alignment = 64;
+    static const size_t chunkBytes = 64 * 1024;
+    static const size_t hugeChunkBytes = 2 * 1024 * 1024;
+
+    RowStore() = default;
+    ~RowStore();
+
+    /*
+    * Dimension and huge pages are chosen while there are no chunks, reserve made before the dimension is known
+    * is done by setDim
+    */
+    bool setDim(size_t dim);
+    size_t getDim() const;
+    void useHugePages(bool enable);
+    bool usesHugePages() const;
+
+    /*
+    * Rows which fit into the allocated chunks
+    */
+    size_t capacity() const;
+    /*
+    * Allocates chunks for count rows in total, returns false if some chunk could not be allocated
+    */
+    bool reserve(size_t count);
+    /*
+    * Frees the chunks past the first count rows
+    */
+    void shrinkToFit(size_t count);
+
+    double *row(size_t idx)
+    {
+        return chunks[idx >> shift] + (idx & mask) * dim;
+    }
+    double const *row(size_t idx) const
+    {
+        return chunks[idx >> shift] + (idx & mask) * dim;
+    }
+
+private:
+    RowStore(const RowStore &store) = delete;
+    RowStore &operator=(const RowStore &store) = delete;
+
+    size_t chunkAlignment() const;
+
+    std::vector<double *> chunks;
+    size_t dim = 0;
+    size_t shift = 0;   // log2 of rows per chunk
+    size_t mask = 0;    // rows per chunk - 1
+    size_t pending = 0; // rows reserved before the dimension was known
+    bool huge = false;
+};
@@ -1,7 +1,11 @@
 #pragma once
 #include "../include/ISet.h"
 #include "../myHeaders/SetControlBlockImpl.h"
-#include <map>
+#include "../myHeaders/SetIndex.h"
+#include "../myHeaders/RowRanks.h"
+#include "../myHeaders/SlotMap.h"
+#include "../myHeaders/RowStore.h"
+#include <vector>
 
 class SetImpl : public ISet
 {
@@ -10,11 +14,16 @@ public:
     static ILogger *getLogger();
 
     static ISet *createSet();
+    static ISet *createSet(IVector::NORM n, double tol);
     ISet *clone() const override;
 
     size_t getDim() const override;
     size_t getSize() const override;
 
+    RC reserve(size_t count, bool hugePages = false) override;
+    RC shrinkToFit() override;
+
+    using ISet::getCopy;
     RC getCopy(size_t index, IVector *&val) const override;
     RC findFirst(IVector const *const &pat, IVector::NORM n, double tol) const override;
     RC findFirstAndCopy(IVector const *const &pat, IVector::NORM n, double tol, IVector *&val) const override;
@@ -24,6 +33,11 @@ public:
                               IVector *const &val) const override;
 
     RC insert(IVector const *const &val, IVector::NORM n, double tol) override;
+    RC findFirst(IVector const *const &pat) const override;
+    RC insert(IVector const *const &val) override;
+    using ISet::insertBatch;
+    RC insertBatch(double const *rows, size_t dim, size_t count, IVector::NORM n, double tol,
+                   RC *statuses = nullptr) override;
 
     RC remove(size_t index) override;
     RC remove(IVector const *const &pat, IVector::NORM n, double tol) override;
@@ -31,7 +45,7 @@ public:
     class IteratorImpl : public IIterator
     {
     public:
-        IteratorImpl(SetImplControlBlock *const &controlBlock, size_t index, IVector *vector);
+        IteratorImpl(SetImplControlBlock *const &controlBlock, size_t index, VectorPtr vector);
 
         IIterator *getNext(size_t indexInc = 1) const override;
         IIterator *getPrevious(size_t indexInc = 1) const override;
@@ -57,7 +71,7 @@ public:
 
     private:
         size_t cur_unique_idx;
-        IVector *cur_vector;
+        VectorPtr cur_vector;
         SetImplControlBlock *control_block;
         static ILogger *logger;
         bool valid;
@@ -69,25 +83,44 @@ public:
 
     ~SetImpl();
 
+    /*
+    * Coordinates of the row in storage order and index lookups for the set algebra
+    */
+    double const *getRow(size_t index) const;
+    size_t findRow(double const *pat, IVector::NORM n, double tol) const;
+
     RC getNextByUniqueIndex(IVector *const &vec, size_t &index, size_t indexInc);
     RC getPrevByUniqueIndex(IVector *const &vec, size_t &index, size_t indexInc);
     RC getFirstByUniqueIndex(IVector *const &vec, size_t &index);
     RC getLastByUniqueIndex(IVector *const &vec, size_t &index);
 
 private:
+    // Removed rows are compacted once there are this many of them and more than live ones
+    static const size_t minCompaction = 64;
+
+    // Makes room in the storage for count more rows
+    bool reserveRows(size_t count);
+    // Appends row unless there is a vector within tol of it
+    RC insertRow(double const *row, IVector::NORM n, double tol);
+    void eraseRow(size_t row);
+    void compact();
+
     static ILogger *logger;
-    double *data;
     SetImplControlBlock *control_block;
-    std::map<size_t, size_t> unique_idxs_to_order;
-    std::map<size_t, size_t> order_idxs_to_unique;
-    size_t last_vec_idx;
-    size_t capacity; // amount of allocated double values
+    SlotMap unique_idxs;             // unique index of a vector to its row
+    std::vector<size_t> row_unique_idxs; // unique index of every row, removed ones included
+    RowStore storage;
     size_t size;     // amount of vectors in set
     size_t dim;      // size of a single vector
+    SetIndex spatial_index; // k-d trees over the rows for tolerance lookups
+    RowRanks ranks;         // live and removed rows of storage in order
+    IVector::NORM default_norm; // metric of insert and findFirst called without one
+    double default_tol;
 
 protected:
     SetImpl();
-    SetImpl(double const *const &other_data, size_t other_size, size_t other_dim,
-            const std::map<size_t, size_t> &other_unique_map, const std::map<size_t, size_t> &other_order_map,
-            size_t other_last_idx);
+    /*
+    * Copy holds the live rows of other only
+    */
+    SetImpl(const SetImpl &other);
 };
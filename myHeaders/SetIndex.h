@@ -0,0 +1,94 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+#include "../include/IVector.h"
+#include "../myHeaders/RowStore.h"
+
+/*
+* Spatial index of the rows of a set for tolerance lookups
+*
+* By default it is the Bentley-Saxe logarithmic method over static k-d trees: level k holds either nothing or 2^k
+* rows, insert merges the full levels below the first empty one into a single new tree, so a row is rebuilt
+* O(log n) times over its life. A lookup walks every level and skips subtrees whose splitting coordinate differs from
+* the pattern by more than tol, which is a lower bound of the distance in every IVector::NORM, then checks the
+* candidates exactly
+*
+* In cell mode rows are hashed by the cube of side cell they fall into instead, and a lookup with tol not greater
+* than cell probes at most the 3^dim cubes around the pattern, which is O(1) on average. Cell mode is dropped for dimensions
+* above maxCellDim, where the k-d trees are cheaper than the probes. Lookups with larger tol scan all rows
+*
+* Index keeps row numbers only, coordinates are read from the store passed to each call. Erased rows keep their
+* numbers and are skipped by lookups, they are dropped from the trees when levels are merged or rebuilt
+*/
+class SetIndex
+{
+public:
+    // Returned by find when no row is within tolerance
+    static const size_t npos = static_cast<size_t>(-1);
+    static const size_t maxCellDim = 6;
+
+    /*
+    * Switches an empty index to cell mode, cell 0 matches equal rows only
+    */
+    void useCells(double cell);
+    bool usesCells() const;
+
+    void clear();
+    /*
+    * Prepares room for count more rows
+    */
+    void reserve(size_t count);
+    /*
+    * Adds row which must be the row with the greatest number so far
+    */
+    void insert(RowStore const &store, size_t row);
+    /*
+    * Indexes rows [0, count) of the store from scratch, rows erased before stay erased until clear
+    */
+    void rebuild(RowStore const &store, size_t count);
+    void erase(size_t row);
+
+    /*
+    * Smallest number of a row within tol of pat, npos if there is none
+    */
+    size_t findFirst(RowStore const &store, double const *pat, IVector::NORM n, double tol) const;
+    /*
+    * Some row within tol of pat, npos if there is none, stops at the first match
+    */
+    size_t findAny(RowStore const &store, double const *pat, IVector::NORM n, double tol) const;
+
+private:
+    struct Query
+    {
+        RowStore const *store;
+        size_t dim;
+        double const *pat;
+        IVector::NORM n;
+        double tol;
+        bool first;     // look for the smallest row rather than for any
+        char const *erased;
+        size_t found;
+    };
+
+    static void build(std::vector<size_t> &rows, size_t lo, size_t hi, size_t depth, RowStore const &store);
+    // Return true when the query may stop
+    static bool search(std::vector<size_t> const &rows, size_t lo, size_t hi, size_t depth, Query &query);
+    static bool visit(size_t row, Query &query);
+    bool probe(int64_t const *lo, int64_t const *hi, size_t axis, uint64_t hash, Query &query) const;
+
+    int64_t cellOf(double coord) const;
+    static uint64_t mix(uint64_t hash, int64_t cell);
+    uint64_t hashOf(double const *coords, size_t dim) const;
+
+    size_t find(RowStore const &store, double const *pat, IVector::NORM n, double tol, bool first) const;
+
+    std::vector<std::vector<size_t>> levels;
+    std::vector<char> erased; // flag of every row, indexed or not
+
+    bool cells = false;
+    double cell = 0;
+    std::unordered_multimap<uint64_t, size_t> buckets;
+    size_t count = 0;
+};
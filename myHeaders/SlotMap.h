@@ -0,0 +1,44 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/*
+* Generational slot map from stable keys to row numbers
+*
+* Key is the generation of a slot in the high 32 bits and the slot in the low ones. Erasing a key bumps the
+* generation of its slot and puts the slot on the free list, so a stale key never finds the row which reuses it.
+* Lookups are two array reads, inserts allocate only when the slots grow
+*/
+class SlotMap
+{
+public:
+    // Returned by find for erased and unknown keys
+    static const size_t npos = static_cast<size_t>(-1);
+
+    void clear();
+    void reserve(size_t count);
+
+    /*
+    * Returns the new key of the row
+    */
+    size_t insert(size_t row);
+    void erase(size_t key);
+    /*
+    * Points the live key to another row, used when rows are moved
+    */
+    void move(size_t key, size_t row);
+
+    size_t find(size_t key) const;
+
+private:
+    struct Slot
+    {
+        size_t row;
+        uint32_t generation;
+        bool used;
+    };
+
+    std::vector<Slot> slots;
+    std::vector<uint32_t> free_slots;
+};
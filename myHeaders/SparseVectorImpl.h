@@ -0,0 +1,52 @@
+#pragma once
+#include "../include/ISparseVector.h"
+
+class SparseVectorImpl : public ISparseVector
+{
+public:
+    static RC setLogger(ILogger* const pLogger);
+    static ILogger* getLogger();
+    static void log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line);
+
+    /*
+    * Returns empty vector with room for capacity nonzeros or nullptr
+    */
+    static SparseVectorImpl* allocate(size_t dim, size_t capacity);
+
+    ISparseVector* clone() const override;
+    IVector* toVector() const override;
+
+    size_t getDim() const override;
+    size_t getNonZeroCount() const override;
+    size_t const* getIndices() const override;
+    double const* getValues() const override;
+
+    RC getCord(size_t index, double& val) const override;
+    RC setCord(size_t index, double val) override;
+
+    RC scale(double multiplier) override;
+    double norm(IVector::NORM n) const override;
+
+    size_t sizeAllocated() const override;
+
+    ~SparseVectorImpl() override;
+
+    /*
+    * Appends nonzero with index greater than all stored ones, room for it must be reserved
+    */
+    void append(size_t index, double value);
+
+private:
+    SparseVectorImpl(size_t dim, size_t capacity, size_t* indices, double* values);
+
+    // Position of the first stored index not less than index
+    size_t lowerBound(size_t index) const;
+    RC reserve(size_t capacity);
+
+    static ILogger* logger;
+    size_t dimension;
+    size_t nnz;
+    size_t capacity;
+    size_t* indices;
+    double* values;
+};
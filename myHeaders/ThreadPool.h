@@ -0,0 +1,25 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+
+/*
+* Shared worker threads for data-parallel loops of the library
+*
+* Workers are started on the first parallel loop. A loop started while another one is running (or from inside a task)
+* is run by the calling thread alone, so nested parallelism never deadlocks
+*/
+namespace ThreadPool
+{
+    /*
+    * Number of threads taking part in a loop, including the calling one, 0 restores one thread per hardware thread
+    */
+    void setThreadCount(size_t count);
+    size_t getThreadCount();
+
+    /*
+    * Calls task(idx) for every idx in [0, count) and returns when all of them are done, tasks must not throw
+    *
+    * Tasks are picked by threads in arbitrary order, so they must write to separate places
+    */
+    void run(size_t count, const std::function<void(size_t)>& task);
+}
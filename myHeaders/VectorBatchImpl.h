@@ -0,0 +1,50 @@
+#pragma once
+#include "../include/IVectorBatch.h"
+
+class VectorBatchImpl : public IVectorBatch
+{
+public:
+    static RC setLogger(ILogger* const pLogger);
+    static ILogger* getLogger();
+    static void log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line);
+
+    /*
+    * Allocates batch with zero coordinates, returns nullptr on failure
+    */
+    static VectorBatchImpl* allocate(size_t dim, size_t count);
+
+    IVectorBatch* clone() const override;
+
+    size_t getDim() const override;
+    size_t getSize() const override;
+
+    RC getCoords(size_t index, IVector* const& val) const override;
+    RC setCoords(size_t index, IVector const* const& val) override;
+    double const* getColumn(size_t axis) const override;
+
+    RC norms(IVector::NORM n, double* result) const override;
+    RC dots(IVector const* const& query, double* result) const override;
+    RC distances(IVector const* const& query, IVector::NORM n, double* result) const override;
+    RC axpy(double multiplier, IVector const* const& op) override;
+    RC pairwiseDistances(IVector::NORM n, double* result) const override;
+
+    ~VectorBatchImpl() override;
+
+    static const size_t alignment = 64;
+
+private:
+    VectorBatchImpl(size_t dim, size_t count, size_t stride, double* data);
+
+    double* column(size_t axis) const;
+    RC checkQuery(IVector const* query, double* result) const;
+    /*
+    * result[i] = distance between the point and vector from + i for every vector starting at from
+    */
+    void distancesFrom(double const* point, size_t from, IVector::NORM n, double* result) const;
+
+    static ILogger* logger;
+    size_t dim;
+    size_t count;
+    size_t stride; // distance between columns, count rounded up to whole cache lines
+    double* data;
+};
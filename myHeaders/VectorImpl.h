@@ -16,11 +16,35 @@ namespace
 
         static void log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line);
 
+        /*
+        * Coordinates start on a cache line dataOffset() bytes after the instance and are followed by zeros up to
+        * paddedDim(dim), so kernels may process whole SIMD registers
+        */
+        static const size_t simdWidth = 8;
+        static size_t dataOffset();
+        static size_t paddedDim(size_t dim);
+
+        /*
+        * Allocates vector with uninitialized coordinates and zero padding
+        */
+        static VectorImpl* allocate(size_t dim);
+
+        /*
+        * Bodies of the methods shared with views, work on any buffer of dim coordinates
+        */
+        static RC setDataOf(double* data, size_t dim, size_t srcDim, double const* ptr_data);
+        static RC scaleOf(double* data, size_t dim, double multiplier);
+        static RC combineOf(double* data, size_t dim, IVector const* op, double sign, size_t len);
+        static double normOf(double const* data, size_t dim, NORM n);
+
         VectorImpl(size_t dim)
         {dimension = dim;}
 
         ~VectorImpl() override;
 
+        // Instances live in blocks of VectorPool
+        static void operator delete(void* ptr);
+
         virtual size_t sizeAllocated() const;
 
         static IVector* createVector(size_t dim, double const* const& ptr_data);
@@ -37,16 +61,25 @@ namespace
 
         virtual RC dec(IVector const* const& op);
 
+        /*
+        * Number of coordinates inc and dec process, padding is included when op is padded as well
+        */
+        size_t lengthWith(IVector const* op) const;
+
         virtual double norm(NORM n) const;
 
         virtual RC applyFunction(const std::function<double(double)>& fun);
 
+        virtual RC applyBatch(const std::function<void(double* values, size_t count)>& fun);
+
         virtual RC foreach(const std::function<void(double)>& fun) const;
 
         //////////////////////GETTERS///////////////
 
         virtual double const* getData() const;
 
+        double* data();
+
         virtual size_t getDim() const;
 
         virtual RC getCord(size_t index, double& val) const;
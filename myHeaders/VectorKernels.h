@@ -0,0 +1,142 @@
+#pragma once
+#include <cstddef>
+
+/*
+* Low-level arithmetic kernels used by IVector implementations
+*
+* Every kernel exists in several variants (AVX-512, AVX2, SSE2 and plain scalar code),
+* the best one supported by the CPU is picked once, when the table is first requested
+*/
+
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define VECTOR_KERNELS_X86
+#endif
+
+namespace VectorKernels
+{
+    enum class ISA {
+        SCALAR,
+        SSE2,
+        AVX2,
+        AVX512
+    };
+
+    struct Table
+    {
+        ISA isa;
+
+        /*
+        * dst[i] = a[i] + sign * b[i], sign is expected to be 1 or -1
+        *
+        * dst may be the same pointer as a
+        */
+        void (*combine)(double* dst, const double* a, const double* b, double sign, size_t n);
+        /*
+        * Checks that every a[i] + sign * b[i] is finite without writing anything
+        */
+        bool (*combineIsFinite)(const double* a, const double* b, double sign, size_t n);
+        /*
+        * Same as combine, also returns whether every result is finite, for destinations that may be thrown away
+        */
+        bool (*combineChecked)(double* dst, const double* a, const double* b, double sign, size_t n);
+
+        /*
+        * dst[i] = coefs[0] * srcs[0][i] + ... + coefs[count - 1] * srcs[count - 1][i]
+        *
+        * dst may be the same pointer as any of srcs
+        */
+        void (*linear)(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n);
+        bool (*linearIsFinite)(const double* coefs, const double* const* srcs, size_t count, size_t n);
+        bool (*linearChecked)(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n);
+
+        void (*scale)(double* dst, const double* a, double multiplier, size_t n);
+        bool (*scaleIsFinite)(const double* a, double multiplier, size_t n);
+
+        // dst[i] = a[i] + c
+        void (*shift)(double* dst, const double* a, double c, size_t n);
+        bool (*shiftIsFinite)(const double* a, double c, size_t n);
+
+        bool (*isFinite)(const double* a, size_t n);
+
+        /*
+        * Reductions keep one partial sum per lane, so the rounding of their results depends on the instruction set.
+        * Elementwise kernels give the same bits with every table
+        */
+        double (*dot)(const double* a, const double* b, size_t n);
+        double (*sumAbs)(const double* a, size_t n);
+        double (*sumSquares)(const double* a, size_t n);
+        double (*maxAbs)(const double* a, size_t n);
+
+        /*
+        * Norms of a - b without storing the difference, maxAbsDiff returns NaN if some difference is NaN
+        */
+        double (*sumAbsDiff)(const double* a, const double* b, size_t n);
+        double (*sumSquaresDiff)(const double* a, const double* b, size_t n);
+        double (*maxAbsDiff)(const double* a, const double* b, size_t n);
+
+        /*
+        * Column kernels of vector batches, acc[i] is updated with the i-th element of a column
+        *
+        * columnSumAbsDiff: acc[i] += |col[i] - c|
+        * columnSumSquaresDiff: acc[i] += (col[i] - c)^2
+        * columnMaxAbsDiff: acc[i] = max(acc[i], |col[i] - c|)
+        * columnAxpy: acc[i] += c * col[i]
+        */
+        void (*columnSumAbsDiff)(double* acc, const double* col, double c, size_t n);
+        void (*columnSumSquaresDiff)(double* acc, const double* col, double c, size_t n);
+        void (*columnMaxAbsDiff)(double* acc, const double* col, double c, size_t n);
+        void (*columnAxpy)(double* acc, const double* col, double c, size_t n);
+
+        /*
+        * Mixed precision kernels over single precision coordinates, every value is widened and accumulated in double
+        *
+        * dotMixed multiplies float coordinates by double ones
+        */
+        double (*dotFloat)(const float* a, const float* b, size_t n);
+        double (*dotMixed)(const float* a, const double* b, size_t n);
+        double (*sumAbsFloat)(const float* a, size_t n);
+        double (*sumSquaresFloat)(const float* a, size_t n);
+        double (*maxAbsFloat)(const float* a, size_t n);
+        double (*sumAbsDiffFloat)(const float* a, const float* b, size_t n);
+        double (*sumSquaresDiffFloat)(const float* a, const float* b, size_t n);
+        double (*maxAbsDiffFloat)(const float* a, const float* b, size_t n);
+
+        /*
+        * Elementwise functions dst[i] = f(a[i]), dst may be the same pointer as a
+        *
+        * exp and log are polynomial approximations within a few ulps of the exact result, every variant computes
+        * them with the same operations. Arguments outside of the domain give the same infinities and NaNs as
+        * std::exp and std::log, clampValues expects lower <= upper
+        */
+        void (*absValues)(double* dst, const double* a, size_t n);
+        void (*sqrtValues)(double* dst, const double* a, size_t n);
+        void (*expValues)(double* dst, const double* a, size_t n);
+        void (*logValues)(double* dst, const double* a, size_t n);
+        // 1 / (1 + exp(-a[i]))
+        void (*sigmoidValues)(double* dst, const double* a, size_t n);
+        void (*clampValues)(double* dst, const double* a, double lower, double upper, size_t n);
+
+        /*
+        * Sparse-dense kernels, coordinate k of a sparse vector is values[k] at position indices[k] of the dense one.
+        * Indices are distinct
+        *
+        * gatherDot: sum of values[k] * dense[indices[k]]
+        * scatterAxpy: dense[indices[k]] += c * values[k]
+        */
+        double (*gatherDot)(const double* values, const size_t* indices, const double* dense, size_t nnz);
+        void (*scatterAxpy)(double* dense, const size_t* indices, const double* values, double c, size_t nnz);
+        bool (*scatterAxpyIsFinite)(const double* dense, const size_t* indices, const double* values, double c, size_t nnz);
+    };
+
+    /*
+    * Table with the best kernels for the current CPU
+    */
+    const Table& get();
+
+    /*
+    * Table for the requested instruction set, falls back to the best supported one below it
+    */
+    const Table& get(ISA isa);
+
+    const char* isaName(ISA isa);
+}
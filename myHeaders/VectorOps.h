@@ -0,0 +1,35 @@
+#pragma once
+#include <cstddef>
+#include <functional>
+#include "../include/IVector.h"
+
+/*
+* Arithmetic over raw coordinate buffers with the overflow checking policy of the calling thread applied
+*
+* Every function returns RC::INFINITY_OVERFLOW if some result coordinate is not finite. Destination is left
+* unchanged in that case, unless the policy is IVector::OVERFLOW_CHECK::DEFERRED
+*/
+namespace VectorOps
+{
+    RC setOverflowCheck(IVector::OVERFLOW_CHECK check);
+    IVector::OVERFLOW_CHECK getOverflowCheck();
+    RC checkDeferredOverflow();
+
+    // dst[i] += sign * src[i]
+    RC combine(double* dst, const double* src, double sign, size_t n);
+    // dst[i] = a[i] + sign * b[i], where dst is a fresh buffer that caller throws away on failure
+    RC combineInto(double* dst, const double* a, const double* b, double sign, size_t n);
+    // dst[i] = coefs[0] * srcs[0][i] + ... + coefs[count - 1] * srcs[count - 1][i], dst may be one of srcs
+    RC linear(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n);
+    // Same as linear, where dst is a fresh buffer that caller throws away on failure
+    RC linearInto(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n);
+    RC scale(double* dst, double multiplier, size_t n);
+    // dst[i] = fun(dst[i]), fun is called once per coordinate
+    RC apply(double* dst, size_t n, const std::function<double(double)>& fun);
+    // fun rewrites all n coordinates in place in one call, under EAGER policy it is given a copy of dst
+    RC applyBatch(double* dst, size_t n, const std::function<void(double*, size_t)>& fun);
+    // dst[indices[k]] += multiplier * values[k], indices are distinct
+    RC scatterAxpy(double* dst, const size_t* indices, const double* values, double multiplier, size_t nnz);
+    // dst[c * stride + i] += shifts[c] for i < n in every one of the columns, shifts are expected to be finite
+    RC shiftColumns(double* dst, size_t stride, const double* shifts, size_t columns, size_t n);
+}
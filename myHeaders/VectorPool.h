@@ -0,0 +1,42 @@
+#pragma once
+#include <cstddef>
+#include "../include/IVector.h"
+
+/*
+* Size-class pooled allocator for vector instances
+*
+* Freed blocks are kept in per-thread free lists (one list per block size, that is per dimension),
+* surplus of a thread goes to a shared depot, so other threads can reuse it
+*
+* While an arena is current on the thread, blocks are bumped from its regions instead
+*/
+namespace VectorPool
+{
+    // Every block starts on a cache line
+    const size_t alignment = 64;
+
+    /*
+    * Returns block of at least size bytes aligned to alignment or nullptr
+    */
+    void* allocate(size_t size);
+    /*
+    * Returns block obtained from allocate() back to the pool
+    */
+    void deallocate(void* ptr);
+
+    void getStats(IVector::PoolStats& stats);
+    /*
+    * Gives blocks cached by the calling thread and by the shared depot back to the system
+    */
+    void release();
+
+    /*
+    * Makes a new arena current for the calling thread, returns its state or nullptr if it could not be allocated
+    */
+    void* pushArena(size_t regionSize);
+    /*
+    * Frees all regions of the arena and makes the previous arena current again
+    */
+    void popArena(void* arena);
+    size_t arenaBytesUsed(void const* arena);
+}
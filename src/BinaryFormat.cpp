@@ -0,0 +1,637 @@
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <new>
+#include "../include/IBinaryFormat.h"
+#include "../include/IVectorView.h"
+#include "../myHeaders/MappedVectorImpl.h"
+#include "../myHeaders/VectorKernels.h"
+
+namespace
+{
+    ILogger* logger = nullptr;
+
+    void log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line)
+    {
+        if (logger != nullptr)
+            logger->log(code, level, srcfile, function, line);
+    }
+
+    const char magic[4] = {'I', 'V', 'B', 'F'};
+    const uint32_t byteOrder = 0x01020304;
+
+    const size_t versionOffset = 4;
+    const size_t typeOffset = 6;
+    const size_t byteOrderOffset = 8;
+    const size_t dimOffset = 16;
+    const size_t countOffset = 24;
+    const size_t payloadOffset = 32;
+
+    template <class T>
+    void store(uint8_t* record, size_t offset, T value)
+    {
+        memcpy(record + offset, &value, sizeof(T));
+    }
+
+    template <class T>
+    T load(uint8_t const* record, size_t offset)
+    {
+        T value;
+        memcpy(&value, record + offset, sizeof(T));
+        return value;
+    }
+
+    /*
+    * Payload size of the record, false if it does not fit in size_t
+    */
+    bool payloadSize(IBinaryFormat::TYPE type, size_t dim, size_t count, size_t& bytes)
+    {
+        const size_t limit = (SIZE_MAX - IBinaryFormat::headerSize) / sizeof(double);
+        size_t words = 0;
+
+        switch (type)
+        {
+            case IBinaryFormat::TYPE::VECTOR:
+            case IBinaryFormat::TYPE::MULTI_INDEX:
+                words = dim;
+                break;
+
+            case IBinaryFormat::TYPE::COMPACT:
+                if (dim > limit / 3)
+                    return false;
+                words = 3 * dim;
+                break;
+
+            case IBinaryFormat::TYPE::SET:
+                if (dim != 0 && count > limit / dim)
+                    return false;
+                words = dim * count;
+                break;
+
+            default:
+                return false;
+        }
+
+        if (words > limit)
+            return false;
+
+        bytes = words * sizeof(double);
+        return true;
+    }
+
+    size_t recordSize(IBinaryFormat::TYPE type, size_t dim, size_t count)
+    {
+        size_t bytes = 0;
+        return payloadSize(type, dim, count, bytes) ? IBinaryFormat::headerSize + bytes : 0;
+    }
+
+    /*
+    * Checks the destination and writes the header, returns the payload or nullptr
+    */
+    uint8_t* beginRecord(IBinaryFormat::TYPE type, size_t dim, size_t count, void* buffer, size_t size, RC& err)
+    {
+        const size_t required = recordSize(type, dim, count);
+
+        if (buffer == nullptr)
+            err = RC::NULLPTR_ERROR;
+        else if (reinterpret_cast<uintptr_t>(buffer) % sizeof(double) != 0 || required == 0)
+            err = RC::INVALID_ARGUMENT;
+        else if (size < required)
+            err = RC::INDEX_OUT_OF_BOUND;
+        else
+            err = RC::SUCCESS;
+
+        if (err != RC::SUCCESS)
+            return nullptr;
+
+        uint8_t* record = static_cast<uint8_t*>(buffer);
+        memset(record, 0, IBinaryFormat::headerSize);
+        memcpy(record, magic, sizeof(magic));
+        store<uint16_t>(record, versionOffset, IBinaryFormat::version);
+        store<uint16_t>(record, typeOffset, static_cast<uint16_t>(type));
+        store<uint32_t>(record, byteOrderOffset, byteOrder);
+        store<uint64_t>(record, dimOffset, dim);
+        store<uint64_t>(record, countOffset, count);
+        store<uint64_t>(record, payloadOffset, required - IBinaryFormat::headerSize);
+
+        return record + IBinaryFormat::headerSize;
+    }
+
+    RC writeIndices(uint8_t* dst, size_t const* indices, size_t dim)
+    {
+        for (size_t i = 0; i < dim; ++i)
+            store<uint64_t>(dst, i * sizeof(uint64_t), indices[i]);
+        return RC::SUCCESS;
+    }
+
+    /*
+    * Writes the record to a temporary buffer and then to the file
+    */
+    template <class Object>
+    RC saveRecord(char const* path, Object const* object)
+    {
+        if (path == nullptr || object == nullptr)
+            return RC::NULLPTR_ERROR;
+
+        const size_t size = IBinaryFormat::getSize(object);
+        if (size == 0)
+            return RC::INVALID_ARGUMENT;
+
+        double* buffer = new (std::nothrow) double[size / sizeof(double)];
+        if (buffer == nullptr)
+            return RC::ALLOCATION_ERROR;
+
+        RC err = IBinaryFormat::write(object, buffer, size);
+        if (err == RC::SUCCESS)
+        {
+            FILE* file = fopen(path, "wb");
+            if (file == nullptr)
+                err = RC::IO_ERROR;
+            else
+            {
+                if (fwrite(buffer, 1, size, file) != size)
+                    err = RC::IO_ERROR;
+                if (fclose(file) != 0)
+                    err = RC::IO_ERROR;
+            }
+        }
+
+        delete[] buffer;
+        return err;
+    }
+
+    /*
+    * Checks the header of the record of the expected type, returns the payload or nullptr
+    */
+    uint8_t const* payloadOf(void const* buffer, size_t size, IBinaryFormat::TYPE type, IBinaryFormat::Header& header, RC& err)
+    {
+        err = IBinaryFormat::readHeader(buffer, size, header);
+        if (err == RC::SUCCESS && header.type != type)
+            err = RC::INVALID_ARGUMENT;
+        if (err != RC::SUCCESS)
+            return nullptr;
+
+        return static_cast<uint8_t const*>(buffer) + IBinaryFormat::headerSize;
+    }
+}
+
+RC IBinaryFormat::setLogger(ILogger* const pLogger)
+{
+    if (pLogger == nullptr)
+        return RC::NULLPTR_ERROR;
+
+    logger = pLogger;
+    return RC::SUCCESS;
+}
+
+ILogger* IBinaryFormat::getLogger()
+{
+    return logger;
+}
+
+///////////////////Writers/////////////////
+
+size_t IBinaryFormat::getSize(IVector const* const& vec)
+{
+    return vec != nullptr ? recordSize(TYPE::VECTOR, vec->getDim(), 1) : 0;
+}
+
+size_t IBinaryFormat::getSize(IMultiIndex const* const& index)
+{
+    return index != nullptr ? recordSize(TYPE::MULTI_INDEX, index->getDim(), 1) : 0;
+}
+
+size_t IBinaryFormat::getSize(ICompact const* const& compact)
+{
+    return compact != nullptr ? recordSize(TYPE::COMPACT, compact->getDim(), 1) : 0;
+}
+
+size_t IBinaryFormat::getSize(ISet const* const& set)
+{
+    return set != nullptr ? recordSize(TYPE::SET, set->getDim(), set->getSize()) : 0;
+}
+
+RC IBinaryFormat::write(IVector const* const& vec, void* buffer, size_t size)
+{
+    if (vec == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    RC err = RC::SUCCESS;
+    uint8_t* payload = beginRecord(TYPE::VECTOR, vec->getDim(), 1, buffer, size, err);
+    if (payload == nullptr)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return err;
+    }
+
+    memcpy(payload, vec->getData(), vec->getDim() * sizeof(double));
+    return RC::SUCCESS;
+}
+
+RC IBinaryFormat::write(IMultiIndex const* const& index, void* buffer, size_t size)
+{
+    if (index == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    RC err = RC::SUCCESS;
+    uint8_t* payload = beginRecord(TYPE::MULTI_INDEX, index->getDim(), 1, buffer, size, err);
+    if (payload == nullptr)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return err;
+    }
+
+    return writeIndices(payload, index->getData(), index->getDim());
+}
+
+RC IBinaryFormat::write(ICompact const* const& compact, void* buffer, size_t size)
+{
+    if (compact == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    const size_t dim = compact->getDim();
+    RC err = RC::SUCCESS;
+    uint8_t* payload = beginRecord(TYPE::COMPACT, dim, 1, buffer, size, err);
+    if (payload == nullptr)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return err;
+    }
+
+    // Boundaries are copied right into the record through views
+    double* coords = reinterpret_cast<double*>(payload);
+    IMutableVectorView left(dim, coords);
+    IMutableVectorView right(dim, coords + dim);
+    IMultiIndex const* grid = compact->getGrid();
+
+    VectorPtr boundary;
+    err = compact->getLeftBoundary(boundary);
+    if (err == RC::SUCCESS)
+        err = left.setData(dim, boundary->getData());
+    if (err == RC::SUCCESS)
+        err = compact->getRightBoundary(boundary);
+    if (err == RC::SUCCESS)
+        err = right.setData(dim, boundary->getData());
+    if (err == RC::SUCCESS && (grid == nullptr || grid->getDim() != dim))
+        err = RC::MISMATCHING_DIMENSIONS;
+    if (err == RC::SUCCESS)
+        err = writeIndices(payload + 2 * dim * sizeof(double), grid->getData(), dim);
+
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+RC IBinaryFormat::write(ISet const* const& set, void* buffer, size_t size)
+{
+    if (set == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    const size_t dim = set->getDim();
+    const size_t count = set->getSize();
+    RC err = RC::SUCCESS;
+    uint8_t* payload = beginRecord(TYPE::SET, dim, count, buffer, size, err);
+    if (payload == nullptr)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return err;
+    }
+
+    double* coords = reinterpret_cast<double*>(payload);
+    IMutableVectorView row(dim, coords);
+    for (size_t i = 0; i < count && err == RC::SUCCESS; ++i)
+    {
+        row.rebind(coords + i * dim);
+        err = set->getCoords(i, &row);
+    }
+
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+RC IBinaryFormat::save(char const* path, IVector const* const& vec)
+{
+    const RC err = saveRecord(path, vec);
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return err;
+}
+
+RC IBinaryFormat::save(char const* path, IMultiIndex const* const& index)
+{
+    const RC err = saveRecord(path, index);
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return err;
+}
+
+RC IBinaryFormat::save(char const* path, ICompact const* const& compact)
+{
+    const RC err = saveRecord(path, compact);
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return err;
+}
+
+RC IBinaryFormat::save(char const* path, ISet const* const& set)
+{
+    const RC err = saveRecord(path, set);
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return err;
+}
+
+///////////////////Readers/////////////////
+
+RC IBinaryFormat::readHeader(void const* buffer, size_t size, Header& header)
+{
+    if (buffer == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    uint8_t const* record = static_cast<uint8_t const*>(buffer);
+    if (size < headerSize || memcmp(record, magic, sizeof(magic)) != 0 ||
+        load<uint16_t>(record, versionOffset) != version || load<uint32_t>(record, byteOrderOffset) != byteOrder)
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    const uint64_t dim = load<uint64_t>(record, dimOffset);
+    const uint64_t count = load<uint64_t>(record, countOffset);
+    const uint64_t payload = load<uint64_t>(record, payloadOffset);
+    const TYPE type = static_cast<TYPE>(load<uint16_t>(record, typeOffset));
+
+    size_t expected = 0;
+    if (dim > SIZE_MAX || count > SIZE_MAX || !payloadSize(type, dim, count, expected) || payload != expected)
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    if (size - headerSize < expected)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    header.type = type;
+    header.dim = dim;
+    header.count = count;
+    return RC::SUCCESS;
+}
+
+RC IBinaryFormat::readHeader(char const* path, Header& header)
+{
+    if (path == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr)
+    {
+        log(RC::FILE_NOT_FOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::FILE_NOT_FOUND;
+    }
+
+    uint8_t record[headerSize];
+    const size_t read = fread(record, 1, headerSize, file);
+    long size = -1;
+    if (fseek(file, 0, SEEK_END) == 0)
+        size = ftell(file);
+    fclose(file);
+
+    if (read != headerSize || size < 0)
+    {
+        log(RC::IO_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::IO_ERROR;
+    }
+
+    // Only the header is at hand, the size of the file tells whether the payload fits
+    return readHeader(record, static_cast<size_t>(size), header);
+}
+
+double const* IBinaryFormat::getCoords(void const* buffer, size_t size, Header& header)
+{
+    RC err = readHeader(buffer, size, header);
+    if (err == RC::SUCCESS && (header.type == TYPE::MULTI_INDEX ||
+                               reinterpret_cast<uintptr_t>(buffer) % sizeof(double) != 0))
+        err = RC::INVALID_ARGUMENT;
+
+    if (err != RC::SUCCESS)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    double const* coords = reinterpret_cast<double const*>(static_cast<uint8_t const*>(buffer) + headerSize);
+    const size_t count = header.type == TYPE::SET ? header.dim * header.count :
+                         header.type == TYPE::COMPACT ? 2 * header.dim : header.dim;
+
+    if (!VectorKernels::get().isFinite(coords, count))
+    {
+        log(RC::NOT_NUMBER, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    return coords;
+}
+
+IVector* IBinaryFormat::readVector(void const* buffer, size_t size)
+{
+    Header header;
+    RC err = RC::SUCCESS;
+    uint8_t const* payload = payloadOf(buffer, size, TYPE::VECTOR, header, err);
+    if (payload == nullptr)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    // Buffer need not be aligned here, so the payload is copied out before its coordinates are checked
+    double* coords = new (std::nothrow) double[header.dim + 1];
+    if (coords == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    memcpy(coords, payload, header.dim * sizeof(double));
+    if (!VectorKernels::get().isFinite(coords, header.dim))
+    {
+        delete[] coords;
+        log(RC::NOT_NUMBER, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    IVector* vec = IVector::createVector(header.dim, coords);
+    delete[] coords;
+
+    return vec;
+}
+
+IMultiIndex* IBinaryFormat::readMultiIndex(void const* buffer, size_t size)
+{
+    Header header;
+    RC err = RC::SUCCESS;
+    uint8_t const* payload = payloadOf(buffer, size, TYPE::MULTI_INDEX, header, err);
+    if (payload == nullptr)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    size_t* indices = new (std::nothrow) size_t[header.dim + 1];
+    if (indices == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < header.dim; ++i)
+        indices[i] = load<uint64_t>(payload, i * sizeof(uint64_t));
+
+    IMultiIndex* index = IMultiIndex::createMultiIndex(header.dim, indices);
+    delete[] indices;
+
+    return index;
+}
+
+ICompact* IBinaryFormat::readCompact(void const* buffer, size_t size)
+{
+    Header header;
+    double const* coords = getCoords(buffer, size, header);
+    if (coords == nullptr)
+        return nullptr;
+
+    if (header.type != TYPE::COMPACT)
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    size_t* nodes = new (std::nothrow) size_t[header.dim + 1];
+    if (nodes == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    uint8_t const* grid = reinterpret_cast<uint8_t const*>(coords + 2 * header.dim);
+    for (size_t i = 0; i < header.dim; ++i)
+        nodes[i] = load<uint64_t>(grid, i * sizeof(uint64_t));
+
+    IVectorView left(header.dim, coords);
+    IVectorView right(header.dim, coords + header.dim);
+    IMultiIndex* quantities = IMultiIndex::createMultiIndex(header.dim, nodes);
+    delete[] nodes;
+
+    ICompact* compact = quantities != nullptr ? ICompact::createCompact(&left, &right, quantities) : nullptr;
+    delete quantities;
+
+    return compact;
+}
+
+ISet* IBinaryFormat::readSet(void const* buffer, size_t size)
+{
+    Header header;
+    double const* coords = getCoords(buffer, size, header);
+    if (coords == nullptr)
+        return nullptr;
+
+    if (header.type != TYPE::SET)
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    ISet* set = ISet::createSet();
+    if (set == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    // Empty set has no dimension to insert with
+    if (header.count == 0)
+        return set;
+
+    // Written sets hold distinct vectors, so nothing is dropped with zero tolerance
+    const RC err = set->insertBatch(coords, header.dim, header.count, IVector::NORM::CHEBYSHEV, 0);
+    if (err != RC::SUCCESS)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        delete set;
+        return nullptr;
+    }
+
+    return set;
+}
+
+IVector* IBinaryFormat::mapVector(char const* path)
+{
+    Header header;
+    RC err = readHeader(path, header);
+    if (err == RC::SUCCESS && header.type != TYPE::VECTOR)
+        err = RC::INVALID_ARGUMENT;
+
+    if (err != RC::SUCCESS)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    // Nothing to map, the vector of dimension 0 is an ordinary one
+    if (header.dim == 0)
+    {
+        const double none = 0;
+        return IVector::createVector(0, &none);
+    }
+
+    return IMappedVectorArray::createVector(path, header.dim, IMappedVectorArray::MODE::READ_ONLY, headerSize);
+}
+
+IMappedVectorArray* IBinaryFormat::mapSet(char const* path)
+{
+    Header header;
+    RC err = readHeader(path, header);
+    if (err == RC::SUCCESS && header.type != TYPE::SET)
+        err = RC::INVALID_ARGUMENT;
+
+    if (err != RC::SUCCESS)
+    {
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    // Empty record has no coordinates to map
+    if (header.dim == 0 || header.count == 0)
+    {
+        IMappedVectorArray* empty =
+            new (std::nothrow) MappedVectorArrayImpl(header.dim, 0, IMappedVectorArray::MODE::READ_ONLY, nullptr);
+        if (empty == nullptr)
+            log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return empty;
+    }
+
+    return IMappedVectorArray::createArray(path, header.dim, header.count, IMappedVectorArray::MODE::READ_ONLY, headerSize);
+}
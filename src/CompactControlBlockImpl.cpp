@@ -61,8 +61,8 @@ RC CompactControlBlockImpl::get(const IMultiIndex* const& currentIndex, IVector*
         }
     }
 
-    IVector* vec = nullptr;
-    RC rc = compact->getVectorCopy(currentIndex, vec);
+    // Coordinates are written straight to the vector of the iterator, no temporary copy is created
+    RC rc = compact->getVectorCoords(currentIndex, val);
 
     if(rc != RC::SUCCESS)
     {
@@ -70,8 +70,6 @@ RC CompactControlBlockImpl::get(const IMultiIndex* const& currentIndex, IVector*
         return rc;
     }
 
-    val->setData(currentIndex->getDim(),vec->getData());
-    delete vec;
     return RC::SUCCESS;
 }
 
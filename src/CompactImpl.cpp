@@ -1,4 +1,5 @@
 #include <cstring>
+#include <utility>
 #include "../myHeaders/CompactImpl.h"
 
 ILogger* CompactImpl::logger = nullptr;
@@ -258,7 +259,7 @@ ICompact::IIterator* CompactImpl::getIterator(const IMultiIndex* const& index, c
         }
     }
 
-    IVector* vec = nullptr;
+    VectorPtr vec;
     RC rc = getVectorCopy(index, vec);
 
     if (rc != RC::SUCCESS)
@@ -270,7 +271,6 @@ ICompact::IIterator* CompactImpl::getIterator(const IMultiIndex* const& index, c
     IMultiIndex* iMultiIndex = index->clone();
     if (iMultiIndex == nullptr)
     {
-        delete vec;
         logger->severe(RC::ALLOCATION_ERROR, __FILE__, __FUNCTION__, __LINE__);
         return nullptr;
     }
@@ -278,16 +278,14 @@ ICompact::IIterator* CompactImpl::getIterator(const IMultiIndex* const& index, c
     IMultiIndex* order = bypassOrder->clone();
     if (order == nullptr)
     {
-        delete vec;
         delete iMultiIndex;
         logger->severe(RC::ALLOCATION_ERROR, __FILE__, __FUNCTION__, __LINE__);
         return nullptr;
     }
 
-    ICompact::IIterator* iterator = new(std::nothrow) CompactImpl::Iterator(vec, iMultiIndex, order, pBlock);
+    ICompact::IIterator* iterator = new(std::nothrow) CompactImpl::Iterator(std::move(vec), iMultiIndex, order, pBlock);
     if (iterator == nullptr)
     {
-        delete vec;
         delete iMultiIndex;
         delete order;
         logger->severe(RC::ALLOCATION_ERROR, __FILE__, __FUNCTION__, __LINE__);
@@ -358,10 +356,10 @@ CompactImpl::~CompactImpl()
     delete order;
 }
 
-CompactImpl::Iterator::Iterator(IVector* iVector_, IMultiIndex* index_, IMultiIndex* bypassOrder_,
+CompactImpl::Iterator::Iterator(VectorPtr iVector_, IMultiIndex* index_, IMultiIndex* bypassOrder_,
                                     const std::shared_ptr<CompactControlBlockImpl>& pBlock_)
 {
-    iVector = iVector_;
+    iVector = std::move(iVector_);
     index = index_;
     bypassOrder = bypassOrder_;
     pBlock = pBlock_;
@@ -382,7 +380,7 @@ ICompact::IIterator* CompactImpl::Iterator::getNext()
 
 ICompact::IIterator* CompactImpl::Iterator::clone() const
 {
-    IVector* vec = iVector->clone();
+    VectorPtr vec = iVector->clonePtr();
     if (vec == nullptr)
     {
         LoggerIterator->severe(RC::ALLOCATION_ERROR, __FILE__, __FUNCTION__, __LINE__);
@@ -392,7 +390,6 @@ ICompact::IIterator* CompactImpl::Iterator::clone() const
     IMultiIndex* multiIndex = index->clone();
     if (multiIndex == nullptr)
     {
-        delete vec;
         LoggerIterator->severe(RC::ALLOCATION_ERROR, __FILE__, __FUNCTION__, __LINE__);
         return nullptr;
     }
@@ -400,16 +397,14 @@ ICompact::IIterator* CompactImpl::Iterator::clone() const
     IMultiIndex* order = bypassOrder->clone();
     if (order == nullptr)
     {
-        delete vec;
         delete multiIndex;
         LoggerIterator->severe(RC::ALLOCATION_ERROR, __FILE__, __FUNCTION__, __LINE__);
         return nullptr;
     }
 
-    IIterator* iterator = new(std::nothrow) CompactImpl::Iterator(vec, multiIndex, order, pBlock);
+    IIterator* iterator = new(std::nothrow) CompactImpl::Iterator(std::move(vec), multiIndex, order, pBlock);
     if (iterator == nullptr)
     {
-        delete vec;
         delete multiIndex;
         delete order;
         LoggerIterator->severe(RC::ALLOCATION_ERROR, __FILE__, __FUNCTION__, __LINE__);
@@ -427,7 +422,7 @@ RC CompactImpl::Iterator::next()
         return rc;
     }
 
-    return pBlock->get(index, iVector);
+    return pBlock->get(index, iVector.get());
 }
 
 bool CompactImpl::Iterator::isValid() const
@@ -468,7 +463,6 @@ RC CompactImpl::Iterator::getVectorCoords(IVector* const& val) const
 
 CompactImpl::Iterator::~Iterator()
 {
-    delete iVector;
     delete index;
     delete bypassOrder;
 }
@@ -0,0 +1,414 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <new>
+#include "../myHeaders/FloatVectorImpl.h"
+#include "../myHeaders/VectorKernels.h"
+#include "../myHeaders/VectorPool.h"
+
+ILogger* FloatVectorImpl::logger = nullptr;
+
+///////////////////IFloatVector/////////////////
+
+RC IFloatVector::setLogger(ILogger* const logger)
+{
+    return FloatVectorImpl::setLogger(logger);
+}
+
+ILogger* IFloatVector::getLogger()
+{
+    return FloatVectorImpl::getLogger();
+}
+
+IFloatVector* IFloatVector::createVector(size_t dim, float const* const& ptr_data)
+{
+    if (ptr_data == nullptr)
+    {
+        FloatVectorImpl::log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    FloatVectorImpl* vec = FloatVectorImpl::allocate(dim);
+    if (vec == nullptr)
+    {
+        FloatVectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    if (vec->setData(dim, ptr_data) != RC::SUCCESS)
+    {
+        delete vec;
+        return nullptr;
+    }
+
+    return vec;
+}
+
+IFloatVector* IFloatVector::createVector(IVector const* const& vec)
+{
+    if (vec == nullptr)
+    {
+        FloatVectorImpl::log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    FloatVectorImpl* result = FloatVectorImpl::allocate(vec->getDim());
+    if (result == nullptr)
+    {
+        FloatVectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    if (result->assign(vec) != RC::SUCCESS)
+    {
+        delete result;
+        return nullptr;
+    }
+
+    return result;
+}
+
+double IFloatVector::dot(IFloatVector const* const& op1, IFloatVector const* const& op2)
+{
+    if (!op1 || !op2 || op1->getDim() != op2->getDim())
+        return std::numeric_limits<double>::quiet_NaN();
+
+    // Products of floats are far below double range, the sum may overflow only for absurd dimensions
+    const double result = VectorKernels::get().dotFloat(op1->getData(), op2->getData(), op1->getDim());
+
+    if (!std::isfinite(result))
+    {
+        FloatVectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return result;
+}
+
+double IFloatVector::dot(IFloatVector const* const& op1, IVector const* const& op2)
+{
+    if (!op1 || !op2 || op1->getDim() != op2->getDim())
+        return std::numeric_limits<double>::quiet_NaN();
+
+    const double result = VectorKernels::get().dotMixed(op1->getData(), op2->getData(), op1->getDim());
+
+    if (!std::isfinite(result))
+    {
+        FloatVectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return result;
+}
+
+double IFloatVector::distance(IFloatVector const* const& op1, IFloatVector const* const& op2, IVector::NORM n)
+{
+    if (!op1 || !op2 || op1->getDim() != op2->getDim())
+    {
+        FloatVectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    float const* a = op1->getData();
+    float const* b = op2->getData();
+    const size_t dim = op1->getDim();
+
+    switch (n)
+    {
+        case IVector::NORM::FIRST:
+            return kernels.sumAbsDiffFloat(a, b, dim);
+
+        case IVector::NORM::SECOND:
+            return sqrt(kernels.sumSquaresDiffFloat(a, b, dim));
+
+        case IVector::NORM::CHEBYSHEV:
+            return kernels.maxAbsDiffFloat(a, b, dim);
+
+        default:
+            FloatVectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return std::numeric_limits<double>::quiet_NaN();
+    }
+}
+
+IFloatVector::~IFloatVector() = default;
+
+///////////////////FloatVectorImpl/////////////////
+
+RC FloatVectorImpl::setLogger(ILogger* const pLogger)
+{
+    if (pLogger == nullptr)
+        return RC::NULLPTR_ERROR;
+
+    logger = pLogger;
+    return RC::SUCCESS;
+}
+
+ILogger* FloatVectorImpl::getLogger()
+{
+    return logger;
+}
+
+void FloatVectorImpl::log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line)
+{
+    if (logger != nullptr)
+        logger->log(code, level, srcfile, function, line);
+}
+
+size_t FloatVectorImpl::dataOffset()
+{
+    return (sizeof(FloatVectorImpl) + VectorPool::alignment - 1) / VectorPool::alignment * VectorPool::alignment;
+}
+
+size_t FloatVectorImpl::paddedDim(size_t dim)
+{
+    return (dim + simdWidth - 1) / simdWidth * simdWidth;
+}
+
+FloatVectorImpl* FloatVectorImpl::allocate(size_t dim)
+{
+    if (dim > (SIZE_MAX - dataOffset()) / sizeof(float) - simdWidth)
+        return nullptr;
+
+    void* block = VectorPool::allocate(dataOffset() + paddedDim(dim) * sizeof(float));
+    if (block == nullptr)
+        return nullptr;
+
+    FloatVectorImpl* vec = new(block) FloatVectorImpl(dim);
+    memset(vec->data() + dim, 0, (paddedDim(dim) - dim) * sizeof(float));
+    return vec;
+}
+
+FloatVectorImpl::FloatVectorImpl(size_t dim) : dimension(dim)
+{
+}
+
+FloatVectorImpl::~FloatVectorImpl() = default;
+
+void FloatVectorImpl::operator delete(void* ptr)
+{
+    VectorPool::deallocate(ptr);
+}
+
+size_t FloatVectorImpl::sizeAllocated() const
+{
+    return dataOffset() + paddedDim(dimension) * sizeof(float);
+}
+
+float* FloatVectorImpl::data()
+{
+    return reinterpret_cast<float*>(reinterpret_cast<uint8_t*>(this) + dataOffset());
+}
+
+float const* FloatVectorImpl::getData() const
+{
+    return reinterpret_cast<float const*>(reinterpret_cast<uint8_t const*>(this) + dataOffset());
+}
+
+size_t FloatVectorImpl::getDim() const
+{
+    return dimension;
+}
+
+IFloatVector* FloatVectorImpl::clone() const
+{
+    return IFloatVector::createVector(dimension, getData());
+}
+
+IVector* FloatVectorImpl::toVector() const
+{
+    double* buffer = new (std::nothrow) double[dimension];
+    if (buffer == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    float const* coords = getData();
+    for (size_t idx = 0; idx < dimension; ++idx)
+        buffer[idx] = coords[idx];
+
+    IVector* result = IVector::createVector(dimension, buffer);
+    delete[] buffer;
+
+    return result;
+}
+
+RC FloatVectorImpl::narrow(float* dst, double const* src, size_t dim)
+{
+    for (size_t idx = 0; idx < dim; ++idx)
+        if (!std::isfinite(static_cast<float>(src[idx])))
+        {
+            const RC err = std::isnan(src[idx]) ? RC::NOT_NUMBER : RC::INFINITY_OVERFLOW;
+            log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return err;
+        }
+
+    for (size_t idx = 0; idx < dim; ++idx)
+        dst[idx] = static_cast<float>(src[idx]);
+
+    return RC::SUCCESS;
+}
+
+RC FloatVectorImpl::assign(IVector const* const& vec)
+{
+    if (vec == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    if (vec->getDim() != dimension)
+    {
+        log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+
+    return narrow(data(), vec->getData(), dimension);
+}
+
+RC FloatVectorImpl::setData(size_t dim, float const* const& ptr_data)
+{
+    if (dim != dimension)
+    {
+        log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+
+    if (ptr_data == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    for (size_t idx = 0; idx < dim; ++idx)
+        if (!std::isfinite(ptr_data[idx]))
+        {
+            log(RC::NOT_NUMBER, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return RC::NOT_NUMBER;
+        }
+
+    memmove(data(), ptr_data, dim * sizeof(float));
+    return RC::SUCCESS;
+}
+
+RC FloatVectorImpl::getCord(size_t index, double& val) const
+{
+    if (index >= dimension)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    val = getData()[index];
+    return RC::SUCCESS;
+}
+
+RC FloatVectorImpl::setCord(size_t index, double val)
+{
+    if (index >= dimension)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    return narrow(data() + index, &val, 1);
+}
+
+RC FloatVectorImpl::scale(double multiplier)
+{
+    if (!std::isfinite(multiplier))
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    float* coords = data();
+    for (size_t idx = 0; idx < dimension; ++idx)
+        if (!std::isfinite(static_cast<float>(coords[idx] * multiplier)))
+        {
+            log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return RC::INFINITY_OVERFLOW;
+        }
+
+    for (size_t idx = 0; idx < dimension; ++idx)
+        coords[idx] = static_cast<float>(coords[idx] * multiplier);
+
+    return RC::SUCCESS;
+}
+
+RC FloatVectorImpl::inc(IFloatVector const* const& op)
+{
+    return combine(op, 1.0);
+}
+
+RC FloatVectorImpl::dec(IFloatVector const* const& op)
+{
+    return combine(op, -1.0);
+}
+
+RC FloatVectorImpl::combine(IFloatVector const* op, double sign)
+{
+    if (op == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    if (op->getDim() != dimension)
+    {
+        log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+
+    float* coords = data();
+    float const* other = op->getData();
+
+    // Sum of two floats is exact in double, so it is rounded only once
+    for (size_t idx = 0; idx < dimension; ++idx)
+        if (!std::isfinite(static_cast<float>(coords[idx] + sign * other[idx])))
+        {
+            log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return RC::INFINITY_OVERFLOW;
+        }
+
+    for (size_t idx = 0; idx < dimension; ++idx)
+        coords[idx] = static_cast<float>(coords[idx] + sign * other[idx]);
+
+    return RC::SUCCESS;
+}
+
+double FloatVectorImpl::norm(IVector::NORM n) const
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    float const* coords = getData();
+    double result = 0;
+
+    switch (n)
+    {
+        case IVector::NORM::FIRST:
+            result = kernels.sumAbsFloat(coords, dimension);
+            break;
+
+        case IVector::NORM::SECOND:
+            result = sqrt(kernels.sumSquaresFloat(coords, dimension));
+            break;
+
+        case IVector::NORM::CHEBYSHEV:
+            result = kernels.maxAbsFloat(coords, dimension);
+            break;
+
+        default:
+            log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (!std::isfinite(result))
+    {
+        log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return result;
+}
@@ -0,0 +1,391 @@
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include "../myHeaders/MappedVectorImpl.h"
+#include "../myHeaders/VectorKernels.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+ILogger* MappedVectorArrayImpl::logger = nullptr;
+
+///////////////////IMappedVectorArray/////////////////
+
+RC IMappedVectorArray::setLogger(ILogger* const logger)
+{
+    return MappedVectorArrayImpl::setLogger(logger);
+}
+
+ILogger* IMappedVectorArray::getLogger()
+{
+    return MappedVectorArrayImpl::getLogger();
+}
+
+IMappedVectorArray* IMappedVectorArray::createArray(char const* path, size_t dim, size_t count, MODE mode, size_t offset)
+{
+    RC err = RC::SUCCESS;
+    FileMapping* mapping = MappedVectorArrayImpl::map(path, dim, count, mode, offset, err);
+    if (mapping == nullptr)
+    {
+        MappedVectorArrayImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    IMappedVectorArray* array = new (std::nothrow) MappedVectorArrayImpl(dim, count, mode, mapping);
+    if (array == nullptr)
+    {
+        delete mapping;
+        MappedVectorArrayImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    }
+
+    return array;
+}
+
+IVector* IMappedVectorArray::createVector(char const* path, size_t dim, MODE mode, size_t offset)
+{
+    RC err = RC::SUCCESS;
+    FileMapping* mapping = MappedVectorArrayImpl::map(path, dim, 1, mode, offset, err);
+    if (mapping == nullptr)
+    {
+        MappedVectorArrayImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    IVector* vector = nullptr;
+    if (mode == MODE::READ_WRITE)
+        vector = new (std::nothrow) MappedMutableVectorView(dim, mapping);
+    else
+        vector = new (std::nothrow) MappedVectorView(dim, mapping);
+
+    if (vector == nullptr)
+    {
+        delete mapping;
+        MappedVectorArrayImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    }
+
+    return vector;
+}
+
+IMappedVectorArray::~IMappedVectorArray() = default;
+
+///////////////////FileMapping/////////////////
+
+FileMapping::FileMapping(void* base, size_t length, size_t shift, void* file, void* mapping) :
+    base(base), length(length), shift(shift), file(file), mapping(mapping)
+{
+}
+
+void* FileMapping::data() const
+{
+    return static_cast<uint8_t*>(base) + shift;
+}
+
+#ifdef _WIN32
+
+FileMapping* FileMapping::create(char const* path, size_t offset, size_t bytes, bool writable, RC& err)
+{
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    const size_t alignedOffset = offset / info.dwAllocationGranularity * info.dwAllocationGranularity;
+    const uint64_t end = (uint64_t)offset + bytes;
+
+    HANDLE file = CreateFileA(path, writable ? GENERIC_READ | GENERIC_WRITE : GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              writable ? OPEN_ALWAYS : OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        err = GetLastError() == ERROR_FILE_NOT_FOUND ? RC::FILE_NOT_FOUND : RC::IO_ERROR;
+        return nullptr;
+    }
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || (!writable && (uint64_t)size.QuadPart < end))
+    {
+        CloseHandle(file);
+        err = RC::IO_ERROR;
+        return nullptr;
+    }
+
+    // Writable mapping of the maximum size beyond the end of the file extends it
+    HANDLE mapping = CreateFileMappingA(file, nullptr, writable ? PAGE_READWRITE : PAGE_READONLY,
+                                        (DWORD)(end >> 32), (DWORD)end, nullptr);
+    if (mapping == nullptr)
+    {
+        CloseHandle(file);
+        err = RC::IO_ERROR;
+        return nullptr;
+    }
+
+    const size_t length = offset - alignedOffset + bytes;
+    void* base = MapViewOfFile(mapping, writable ? FILE_MAP_WRITE : FILE_MAP_READ, (DWORD)((uint64_t)alignedOffset >> 32),
+                               (DWORD)alignedOffset, length);
+    if (base == nullptr)
+    {
+        CloseHandle(mapping);
+        CloseHandle(file);
+        err = RC::IO_ERROR;
+        return nullptr;
+    }
+
+    FileMapping* result = new (std::nothrow) FileMapping(base, length, offset - alignedOffset, file, mapping);
+    if (result == nullptr)
+    {
+        UnmapViewOfFile(base);
+        CloseHandle(mapping);
+        CloseHandle(file);
+        err = RC::ALLOCATION_ERROR;
+    }
+
+    return result;
+}
+
+RC FileMapping::flush()
+{
+    if (!FlushViewOfFile(base, length) || !FlushFileBuffers(file))
+        return RC::IO_ERROR;
+
+    return RC::SUCCESS;
+}
+
+FileMapping::~FileMapping()
+{
+    UnmapViewOfFile(base);
+    CloseHandle(mapping);
+    CloseHandle(file);
+}
+
+#else
+
+FileMapping* FileMapping::create(char const* path, size_t offset, size_t bytes, bool writable, RC& err)
+{
+    const size_t pageSize = (size_t)sysconf(_SC_PAGESIZE);
+    const size_t alignedOffset = offset / pageSize * pageSize;
+
+    const int fd = open(path, writable ? O_RDWR | O_CREAT : O_RDONLY, 0644);
+    if (fd < 0)
+    {
+        err = errno == ENOENT ? RC::FILE_NOT_FOUND : RC::IO_ERROR;
+        return nullptr;
+    }
+
+    struct stat info;
+    bool ok = fstat(fd, &info) == 0;
+    if (ok && (uint64_t)info.st_size < (uint64_t)offset + bytes)
+    {
+        // Read-only file must already hold the vectors, writable one is extended with zeros
+        ok = writable && ftruncate(fd, (off_t)(offset + bytes)) == 0;
+    }
+
+    const size_t length = offset - alignedOffset + bytes;
+    void* base = MAP_FAILED;
+    if (ok)
+    {
+        base = mmap(nullptr, length, writable ? PROT_READ | PROT_WRITE : PROT_READ, writable ? MAP_SHARED : MAP_PRIVATE,
+                    fd, (off_t)alignedOffset);
+    }
+
+    // Mapping keeps its own reference to the file
+    close(fd);
+
+    if (base == MAP_FAILED)
+    {
+        err = RC::IO_ERROR;
+        return nullptr;
+    }
+
+    FileMapping* result = new (std::nothrow) FileMapping(base, length, offset - alignedOffset, nullptr, nullptr);
+    if (result == nullptr)
+    {
+        munmap(base, length);
+        err = RC::ALLOCATION_ERROR;
+    }
+
+    return result;
+}
+
+RC FileMapping::flush()
+{
+    return msync(base, length, MS_SYNC) == 0 ? RC::SUCCESS : RC::IO_ERROR;
+}
+
+FileMapping::~FileMapping()
+{
+    munmap(base, length);
+}
+
+#endif
+
+///////////////////MappedVectorArrayImpl/////////////////
+
+RC MappedVectorArrayImpl::setLogger(ILogger* const pLogger)
+{
+    if (pLogger == nullptr)
+        return RC::NULLPTR_ERROR;
+
+    logger = pLogger;
+    return RC::SUCCESS;
+}
+
+ILogger* MappedVectorArrayImpl::getLogger()
+{
+    return logger;
+}
+
+void MappedVectorArrayImpl::log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line)
+{
+    if (logger != nullptr)
+        logger->log(code, level, srcfile, function, line);
+}
+
+FileMapping* MappedVectorArrayImpl::map(char const* path, size_t dim, size_t count, MODE mode, size_t offset, RC& err)
+{
+    if (path == nullptr)
+    {
+        err = RC::NULLPTR_ERROR;
+        return nullptr;
+    }
+
+    if (dim == 0 || count == 0 || count > SIZE_MAX / sizeof(double) / dim || offset % sizeof(double) != 0 ||
+        (mode != MODE::READ_ONLY && mode != MODE::READ_WRITE))
+    {
+        err = RC::INVALID_ARGUMENT;
+        return nullptr;
+    }
+
+    FileMapping* mapping = FileMapping::create(path, offset, dim * count * sizeof(double), mode == MODE::READ_WRITE, err);
+    if (mapping == nullptr)
+        return nullptr;
+
+    if (!VectorKernels::get().isFinite(static_cast<double const*>(mapping->data()), dim * count))
+    {
+        delete mapping;
+        err = RC::INVALID_ARGUMENT;
+        return nullptr;
+    }
+
+    return mapping;
+}
+
+MappedVectorArrayImpl::MappedVectorArrayImpl(size_t dim, size_t count, MODE mode, FileMapping* mapping) :
+    dim(dim), count(count), mode(mode), mapping(mapping)
+{
+}
+
+MappedVectorArrayImpl::~MappedVectorArrayImpl()
+{
+    delete mapping;
+}
+
+size_t MappedVectorArrayImpl::getDim() const
+{
+    return dim;
+}
+
+size_t MappedVectorArrayImpl::getSize() const
+{
+    return count;
+}
+
+IMappedVectorArray::MODE MappedVectorArrayImpl::getMode() const
+{
+    return mode;
+}
+
+double const* MappedVectorArrayImpl::getData(size_t index) const
+{
+    if (index >= count)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    return static_cast<double const*>(mapping->data()) + index * dim;
+}
+
+double* MappedVectorArrayImpl::getMutableData(size_t index)
+{
+    if (mode != MODE::READ_WRITE)
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    return const_cast<double*>(getData(index));
+}
+
+RC MappedVectorArrayImpl::getCoords(size_t index, IVector* const& val) const
+{
+    if (val == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    double const* coords = getData(index);
+    if (coords == nullptr)
+        return RC::INDEX_OUT_OF_BOUND;
+
+    return val->setData(dim, coords);
+}
+
+RC MappedVectorArrayImpl::setCoords(size_t index, IVector const* const& val)
+{
+    if (val == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    if (val->getDim() != dim)
+    {
+        log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+
+    double* coords = getMutableData(index);
+    if (coords == nullptr)
+        return index >= count ? RC::INDEX_OUT_OF_BOUND : RC::INVALID_ARGUMENT;
+
+    memcpy(coords, val->getData(), dim * sizeof(double));
+    return RC::SUCCESS;
+}
+
+RC MappedVectorArrayImpl::flush()
+{
+    if (mode != MODE::READ_WRITE)
+        return RC::SUCCESS;
+
+    RC err = mapping->flush();
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+///////////////////MappedVectorView/////////////////
+
+MappedVectorView::MappedVectorView(size_t dim, FileMapping* mapping) :
+    IVectorView(dim, static_cast<double const*>(mapping->data())), mapping(mapping)
+{
+}
+
+MappedVectorView::~MappedVectorView()
+{
+    delete mapping;
+}
+
+MappedMutableVectorView::MappedMutableVectorView(size_t dim, FileMapping* mapping) :
+    IMutableVectorView(dim, static_cast<double*>(mapping->data())), mapping(mapping)
+{
+}
+
+MappedMutableVectorView::~MappedMutableVectorView()
+{
+    delete mapping;
+}
@@ -0,0 +1,111 @@
+#include "../myHeaders/RowRanks.h"
+
+namespace
+{
+    size_t lowbit(size_t idx)
+    {
+        return idx & (~idx + 1);
+    }
+}
+
+void RowRanks::reset(size_t count)
+{
+    flags.assign(count, 1);
+    tree.resize(count + 1);
+    for (size_t idx = 1; idx <= count; ++idx)
+    {
+        tree[idx] = lowbit(idx);
+    }
+    liveCount = count;
+}
+
+void RowRanks::append()
+{
+    if (tree.empty())
+    {
+        tree.push_back(0);
+    }
+
+    // New node covers the rows of the nodes below it and itself
+    const size_t idx = tree.size();
+    tree.push_back(1 + rank(idx - 1) - rank(idx - lowbit(idx)));
+    flags.push_back(1);
+    ++liveCount;
+}
+
+void RowRanks::erase(size_t row)
+{
+    if (row >= flags.size() || flags[row] == 0)
+    {
+        return;
+    }
+
+    flags[row] = 0;
+    --liveCount;
+    for (size_t idx = row + 1; idx < tree.size(); idx += lowbit(idx))
+    {
+        --tree[idx];
+    }
+}
+
+bool RowRanks::isLive(size_t row) const
+{
+    return row < flags.size() && flags[row] != 0;
+}
+
+size_t RowRanks::rows() const
+{
+    return flags.size();
+}
+
+size_t RowRanks::live() const
+{
+    return liveCount;
+}
+
+size_t RowRanks::removed() const
+{
+    return flags.size() - liveCount;
+}
+
+size_t RowRanks::rank(size_t row) const
+{
+    // Without removed rows positions are the row numbers
+    if (liveCount == flags.size())
+    {
+        return row;
+    }
+
+    size_t sum = 0;
+    for (size_t idx = row; idx > 0; idx -= lowbit(idx))
+    {
+        sum += tree[idx];
+    }
+    return sum;
+}
+
+size_t RowRanks::select(size_t position) const
+{
+    if (liveCount == flags.size())
+    {
+        return position;
+    }
+
+    size_t step = 1;
+    while (step * 2 < tree.size())
+    {
+        step *= 2;
+    }
+
+    // Greatest prefix of rows holding at most position live ones, the wanted row follows it
+    size_t idx = 0;
+    for (; step > 0; step /= 2)
+    {
+        if (idx + step < tree.size() && tree[idx + step] <= position)
+        {
+            idx += step;
+            position -= tree[idx];
+        }
+    }
+    return idx;
+}
@@ -0,0 +1,106 @@
+#include "../myHeaders/RowStore.h"
+#include <new>
+
+#ifdef __linux__
+#include <sys/mman.h>
+#endif
+
+RowStore::~RowStore()
+{
+    shrinkToFit(0);
+}
+
+bool RowStore::setDim(size_t rowDim)
+{
+    if (!chunks.empty() || rowDim == 0)
+    {
+        return false;
+    }
+
+    dim = rowDim;
+
+    // As many rows as fit into a chunk, rounded down to a power of two, but at least one
+    const size_t bytes = huge ? hugeChunkBytes : chunkBytes;
+    shift = 0;
+    while ((size_t(2) << shift) * dim * sizeof(double) <= bytes)
+    {
+        ++shift;
+    }
+    mask = (size_t(1) << shift) - 1;
+
+    const size_t count = pending;
+    pending = 0;
+    return reserve(count);
+}
+
+size_t RowStore::getDim() const
+{
+    return dim;
+}
+
+void RowStore::useHugePages(bool enable)
+{
+    if (chunks.empty())
+    {
+        huge = enable;
+        if (dim != 0)
+        {
+            const size_t rowDim = dim;
+            dim = 0;
+            setDim(rowDim);
+        }
+    }
+}
+
+bool RowStore::usesHugePages() const
+{
+    return huge;
+}
+
+size_t RowStore::capacity() const
+{
+    return chunks.size() << shift;
+}
+
+size_t RowStore::chunkAlignment() const
+{
+    return huge ? hugeChunkBytes : alignment;
+}
+
+bool RowStore::reserve(size_t count)
+{
+    if (dim == 0)
+    {
+        pending = count > pending ? count : pending;
+        return true;
+    }
+
+    const size_t bytes = (mask + 1) * dim * sizeof(double);
+    while (capacity() < count)
+    {
+        void *chunk = ::operator new(bytes, std::align_val_t(chunkAlignment()), std::nothrow);
+        if (chunk == nullptr)
+        {
+            return false;
+        }
+#ifdef MADV_HUGEPAGE
+        if (huge)
+        {
+            madvise(chunk, bytes, MADV_HUGEPAGE);
+        }
+#endif
+        chunks.push_back(static_cast<double *>(chunk));
+    }
+    return true;
+}
+
+void RowStore::shrinkToFit(size_t count)
+{
+    const size_t used = (count + mask) >> shift;
+    while (chunks.size() > used)
+    {
+        ::operator delete(chunks.back(), std::align_val_t(chunkAlignment()));
+        chunks.pop_back();
+    }
+    chunks.shrink_to_fit();
+}
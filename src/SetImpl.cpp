@@ -1,7 +1,11 @@
 #include "../myHeaders/SetImpl.h"
 #include "../include/ISetControlBlock.h"
+#include "../include/IVectorView.h"
+#include "../include/IVectorBatch.h"
+#include "../myHeaders/ThreadPool.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
-#include <map>
 #include <vector>
 #include <iostream>
 
@@ -23,6 +27,11 @@ ISet *ISet::createSet()
     return SetImpl::createSet();
 }
 
+ISet *ISet::createSet(IVector::NORM n, double tol)
+{
+    return SetImpl::createSet(n, tol);
+}
+
 RC SetImpl::setLogger(ILogger *const pLogger)
 {
     if (pLogger == nullptr)
@@ -41,9 +50,35 @@ ISet *SetImpl::createSet()
     return new (std::nothrow) SetImpl;
 }
 
+ISet *SetImpl::createSet(IVector::NORM n, double tol)
+{
+    if (n == IVector::NORM::AMOUNT || !(tol >= 0) || std::isinf(tol))
+    {
+        logger->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+
+    // Cells bound the distance along each axis, which is not greater than the distance in any norm
+    SetImpl *set = new (std::nothrow) SetImpl;
+    if (set != nullptr)
+    {
+        set->spatial_index.useCells(tol);
+        set->default_norm = n;
+        set->default_tol = tol;
+    }
+    return set;
+}
+
 ISet *SetImpl::clone() const
 {
-    return new (std::nothrow) SetImpl(data, size, dim, unique_idxs_to_order, order_idxs_to_unique, last_vec_idx);
+    SetImpl *copy = new (std::nothrow) SetImpl(*this);
+    if (copy != nullptr && copy->storage.capacity() < size)
+    {
+        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        delete copy;
+        return nullptr;
+    }
+    return copy;
 }
 
 size_t SetImpl::getDim() const
@@ -56,6 +91,38 @@ size_t SetImpl::getSize() const
     return size;
 }
 
+RC SetImpl::reserve(size_t count, bool hugePages)
+{
+    // false keeps the mode the set already has
+    if (hugePages && !storage.usesHugePages())
+    {
+        if (storage.capacity() != 0)
+        {
+            logger->warning(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+            return RC::INVALID_ARGUMENT;
+        }
+        storage.useHugePages(hugePages);
+    }
+
+    // Removed rows keep their place until compaction
+    if (!storage.reserve(ranks.rows() - size + count))
+    {
+        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    return RC::SUCCESS;
+}
+
+RC SetImpl::shrinkToFit()
+{
+    if (ranks.removed() != 0)
+    {
+        compact();
+    }
+    storage.shrinkToFit(ranks.rows());
+    return RC::SUCCESS;
+}
+
 RC SetImpl::getCopy(size_t index, IVector *&val) const
 {
     if (size == 0)
@@ -70,14 +137,7 @@ RC SetImpl::getCopy(size_t index, IVector *&val) const
         return RC::INDEX_OUT_OF_BOUND;
     }
 
-    double *buffer = new double[dim];
-    for (size_t idx = 0; idx < dim; ++idx)
-    {
-        buffer[idx] = data[index * dim + idx];
-    }
-
-    val = IVector::createVector(dim, buffer);
-    delete[] buffer;
+    val = IVector::createVector(dim, storage.row(ranks.select(index)));
 
     return RC::SUCCESS;
 }
@@ -114,33 +174,11 @@ RC SetImpl::findFirst(IVector const *const &pat, IVector::NORM n, double tol) co
         return RC::INFINITY_OVERFLOW;
     }
 
-    for (size_t vec_idx = 0; vec_idx < size; ++vec_idx)
+    if (spatial_index.findAny(storage, pat->getData(), n, tol) == SetIndex::npos)
     {
-        bool found = false;
-        double *cur_data = new double[dim];
-
-        for (size_t idx = 0; idx < dim; ++idx)
-        {
-            cur_data[idx] = data[vec_idx * dim + idx];
-        }
-
-        IVector *cur_vec = IVector::createVector(dim, cur_data);
-
-        if (IVector::equals(pat, cur_vec, n, tol))
-        {
-            found = true;
-        }
-
-
-        delete[] cur_data;
-        delete cur_vec;
-        if (found)
-        {
-            return RC::SUCCESS;
-        }
-
+        return RC::VECTOR_NOT_FOUND;
     }
-    return RC::VECTOR_NOT_FOUND;
+    return RC::SUCCESS;
 }
 
 RC SetImpl::findFirstAndCopy(IVector const *const &pat, IVector::NORM n, double tol, IVector *&val) const
@@ -175,35 +213,15 @@ RC SetImpl::findFirstAndCopy(IVector const *const &pat, IVector::NORM n, double
         return RC::INFINITY_OVERFLOW;
     }
 
-    for (size_t vec_idx = 0; vec_idx < size; ++vec_idx)
+    const size_t vec_idx = spatial_index.findFirst(storage, pat->getData(), n, tol);
+    if (vec_idx == SetIndex::npos)
     {
-        bool found = false;
-        double *cur_data = new double[dim];
-
-        for (size_t idx = 0; idx < dim; ++idx)
-        {
-            cur_data[idx] = data[vec_idx * dim + idx];
-        }
-
-        IVector *cur_vec = IVector::createVector(dim, cur_data);
-
-        if (IVector::equals(pat, cur_vec, n, tol))
-        {
-            found = true;
-
-        }
-
-        delete[] cur_data;
-        if (found)
-        {
-            val = cur_vec;
-            return RC::SUCCESS;
-        }
-
-        delete cur_vec;
+        val = nullptr;
+        return RC::VECTOR_NOT_FOUND;
     }
-    val = nullptr;
-    return RC::VECTOR_NOT_FOUND;
+
+    val = IVector::createVector(dim, storage.row(vec_idx));
+    return RC::SUCCESS;
 }
 
 RC SetImpl::getCoords(size_t index, IVector *const &val) const
@@ -226,16 +244,7 @@ RC SetImpl::getCoords(size_t index, IVector *const &val) const
         return RC::NULLPTR_ERROR;
     }
 
-    double *buffer = new double[dim];
-    for (size_t idx = 0; idx < dim; ++idx)
-    {
-        buffer[idx] = data[index * dim + idx];
-    }
-
-    RC err = val->setData(dim, buffer);
-    delete[] buffer;
-
-    return err;
+    return val->setData(dim, storage.row(ranks.select(index)));
 }
 
 RC SetImpl::findFirstAndCopyCoords(IVector const *const &pat, IVector::NORM n, double tol, IVector *const &val) const
@@ -270,33 +279,22 @@ RC SetImpl::findFirstAndCopyCoords(IVector const *const &pat, IVector::NORM n, d
         return RC::INFINITY_OVERFLOW;
     }
 
-    for (size_t vec_idx = 0; vec_idx < size; ++vec_idx)
+    const size_t vec_idx = spatial_index.findFirst(storage, pat->getData(), n, tol);
+    if (vec_idx == SetIndex::npos)
     {
-        bool found = false;
-        double *cur_data = new double[dim];
-
-        for (size_t idx = 0; idx < dim; ++idx)
-        {
-            cur_data[idx] = data[vec_idx * dim + idx];
-        }
-        IVector *cur_vec = IVector::createVector(dim, cur_data);
-
-        if (IVector::equals(pat, cur_vec, n, tol))
-        {
-            found = true;
-        }
+        return RC::VECTOR_NOT_FOUND;
+    }
+    return val->setData(dim, storage.row(vec_idx));
+}
 
-        delete cur_vec;
-        if (found)
-        {
-            RC err = val->setData(dim, cur_data);
-            delete[] cur_data;
-            return err;
-        }
+RC SetImpl::findFirst(IVector const *const &pat) const
+{
+    return findFirst(pat, default_norm, default_tol);
+}
 
-        delete[] cur_data;
-    }
-    return RC::VECTOR_NOT_FOUND;
+RC SetImpl::insert(IVector const *const &val)
+{
+    return insert(val, default_norm, default_tol);
 }
 
 RC SetImpl::insert(IVector const *const &val, IVector::NORM n, double tol)
@@ -304,6 +302,7 @@ RC SetImpl::insert(IVector const *const &val, IVector::NORM n, double tol)
     if (dim == 0)
     {
         dim = val->getDim();
+        storage.setDim(dim);
     }
     else if (dim != val->getDim())
     {
@@ -311,56 +310,133 @@ RC SetImpl::insert(IVector const *const &val, IVector::NORM n, double tol)
         return RC::MISMATCHING_DIMENSIONS;
     }
 
-    if (size == 0)
+    if (!reserveRows(1))
     {
-        last_vec_idx = 0;
+        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
     }
+    RC err = insertRow(val->getData(), n, tol);
+    if (err != RC::SUCCESS)
+    {
+        logger->warning(err, __FILE__, __func__, __LINE__);
+    }
+    return err;
+}
 
-    const double *vec_data = val->getData();
-    for (size_t vec_idx = 0; vec_idx < size; ++vec_idx)
+RC SetImpl::insertBatch(double const *rows, size_t rows_dim, size_t count, IVector::NORM n, double tol, RC *statuses)
+{
+    if (rows == nullptr && count != 0)
     {
-        double *sub = new double[dim];
-        for (size_t idx = 0; idx < dim; ++idx)
-        {
-            sub[idx] = fabs(vec_data[idx] - data[vec_idx * dim + idx]);
-        }
+        logger->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
 
-        IVector *tmp = IVector::createVector(dim, sub);
-        if (tmp->norm(n) <= tol)
-        {
-            delete[] sub;
+    if (rows_dim == 0 || (dim != 0 && dim != rows_dim))
+    {
+        logger->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
 
-            delete tmp;
-            logger->warning(RC::VECTOR_ALREADY_EXIST, __FILE__, __func__, __LINE__);
-            return RC::VECTOR_ALREADY_EXIST;
-        }
-        delete[] sub;
-        delete tmp;
+    if (n == IVector::NORM::AMOUNT || tol < 0)
+    {
+        logger->severe(RC::INVALID_ARGUMENT, __FILE__, __func__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    if (std::isnan(tol))
+    {
+        logger->severe(RC::NOT_NUMBER, __FILE__, __func__, __LINE__);
+        return RC::NOT_NUMBER;
     }
 
-    while (capacity < size * dim + val->getDim())
+    if (std::isinf(tol))
+    {
+        logger->severe(RC::INFINITY_OVERFLOW, __FILE__, __func__, __LINE__);
+        return RC::INFINITY_OVERFLOW;
+    }
+
+    if (count == 0)
+    {
+        return RC::SUCCESS;
+    }
+
+    if (dim == 0)
     {
-        capacity *= 2;
-        double *tmp = new double[capacity];
-        for (size_t idx = 0; idx < size * dim; ++idx)
+        dim = rows_dim;
+        storage.setDim(dim);
+    }
+    if (!reserveRows(count))
+    {
+        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+    if (row_unique_idxs.capacity() < ranks.rows() + count)
+    {
+        row_unique_idxs.reserve(std::max(ranks.rows() + count, 2 * row_unique_idxs.capacity()));
+    }
+    unique_idxs.reserve(size + count);
+    spatial_index.reserve(count);
+
+    // Every inserted row is indexed at once, so later rows of the batch are checked against it in the same lookup
+    RC result = RC::SUCCESS;
+    for (size_t vec_idx = 0; vec_idx < count; ++vec_idx)
+    {
+        double const *row = rows + vec_idx * dim;
+
+        RC err = RC::SUCCESS;
+        for (size_t idx = 0; idx < dim && err == RC::SUCCESS; ++idx)
         {
-            tmp[idx] = data[idx];
+            if (std::isnan(row[idx]))
+            {
+                err = RC::NOT_NUMBER;
+            }
+            else if (std::isinf(row[idx]))
+            {
+                err = RC::INFINITY_OVERFLOW;
+            }
         }
 
-        delete[] data;
-        data = tmp;
+        if (err == RC::SUCCESS)
+        {
+            err = insertRow(row, n, tol);
+        }
+        if (statuses != nullptr)
+        {
+            statuses[vec_idx] = err;
+        }
+        if (result == RC::SUCCESS)
+        {
+            result = err;
+        }
     }
 
-    for (size_t idx = 0; idx < dim; ++idx)
+    return result;
+}
+
+bool SetImpl::reserveRows(size_t count)
+{
+    return storage.reserve(ranks.rows() + count);
+}
+
+RC SetImpl::insertRow(double const *vec_data, IVector::NORM n, double tol)
+{
+    if (spatial_index.findAny(storage, vec_data, n, tol) != SetIndex::npos)
     {
-        data[size * dim + idx] = vec_data[idx];
+        return RC::VECTOR_ALREADY_EXIST;
     }
 
-    unique_idxs_to_order.insert(std::pair<size_t, size_t>(last_vec_idx, size));
-    order_idxs_to_unique.insert(std::pair<size_t, size_t>(size, last_vec_idx));
+    // New row goes after the removed ones too, they are dropped by compaction only
+    const size_t row = ranks.rows();
+    double *dest = storage.row(row);
+    for (size_t idx = 0; idx < dim; ++idx)
+    {
+        dest[idx] = vec_data[idx];
+    }
 
+    row_unique_idxs.push_back(unique_idxs.insert(row));
+    spatial_index.insert(storage, row);
+    ranks.append();
     ++size;
-    ++last_vec_idx;
 
     return RC::SUCCESS;
 }
@@ -379,30 +455,11 @@ RC SetImpl::remove(size_t index)
         return RC::INDEX_OUT_OF_BOUND;
     }
 
-    double *new_data = new double[capacity];
-    std::map<size_t, size_t> new_unique_idxs_to_order;
-    std::map<size_t, size_t> new_order_idxs_to_unique;
-
-    for (size_t vec_idx = 0, new_idx = 0, new_vec_idx = 0; vec_idx < size; ++vec_idx)
+    eraseRow(ranks.select(index));
+    if (size == 0 || (ranks.removed() >= minCompaction && ranks.removed() > size))
     {
-        if (vec_idx != index)
-        {
-            new_unique_idxs_to_order.insert(std::pair<size_t, size_t>(order_idxs_to_unique.at(vec_idx), new_vec_idx));
-            new_order_idxs_to_unique.insert(std::pair<size_t, size_t>(new_vec_idx, unique_idxs_to_order.at(vec_idx)));
-            ++new_vec_idx;
-
-            for (size_t idx = 0; idx < dim; ++idx, ++new_idx)
-            {
-                new_data[new_idx] = data[vec_idx * size + idx];
-            }
-        }
+        compact();
     }
-    delete[] data;
-    data = new_data;
-
-    unique_idxs_to_order = new_unique_idxs_to_order;
-    order_idxs_to_unique = new_order_idxs_to_unique;
-    --size;
 
     return RC::SUCCESS;
 }
@@ -445,51 +502,60 @@ RC SetImpl::remove(IVector const *const &pat, IVector::NORM n, double tol)
         return RC::INFINITY_OVERFLOW;
     }
 
-    double *new_data = new double[capacity];
-    std::vector<size_t> removed_idxs;
-    std::map<size_t, size_t> new_unique_idxs_to_order;
-    std::map<size_t, size_t> new_order_idxs_to_unique;
-
-    for (size_t vec_idx = 0, new_idx = 0, new_vec_idx = 0; vec_idx < size; ++vec_idx)
+    for (size_t row = spatial_index.findAny(storage, pat->getData(), n, tol); row != SetIndex::npos;
+         row = spatial_index.findAny(storage, pat->getData(), n, tol))
+    {
+        eraseRow(row);
+    }
+    if (size == 0 || (ranks.removed() >= minCompaction && ranks.removed() > size))
     {
-        double *cur_data = new double[dim];
+        compact();
+    }
 
-        for (size_t idx = 0; idx < dim; ++idx)
-        {
-            cur_data[idx] = data[vec_idx * dim + idx];
-        }
+    return RC::SUCCESS;
+}
 
-        IVector *cur_vec = IVector::createVector(dim, cur_data);
+void SetImpl::eraseRow(size_t row)
+{
+    unique_idxs.erase(row_unique_idxs[row]);
+    spatial_index.erase(row);
+    ranks.erase(row);
+    --size;
+}
 
-        if (!IVector::equals(pat, cur_vec, n, tol))
+void SetImpl::compact()
+{
+    // Live rows move down in order, so positions and unique indices stay as they were
+    for (size_t row = 0, new_row = 0; row < ranks.rows(); ++row)
+    {
+        if (!ranks.isLive(row))
         {
-            new_unique_idxs_to_order.insert(std::pair<size_t, size_t>(order_idxs_to_unique.at(vec_idx), new_vec_idx));
-            new_order_idxs_to_unique.insert(std::pair<size_t, size_t>(new_vec_idx, unique_idxs_to_order.at(vec_idx)));
-            ++new_vec_idx;
+            continue;
+        }
 
-            for (size_t idx = 0; idx < dim; ++idx, ++new_idx)
+        if (new_row != row)
+        {
+            double const *src = storage.row(row);
+            double *dest = storage.row(new_row);
+            for (size_t idx = 0; idx < dim; ++idx)
             {
-                new_data[new_idx] = data[vec_idx * size + idx];
+                dest[idx] = src[idx];
             }
-
         }
 
-        delete[] cur_data;
-        delete cur_vec;
+        row_unique_idxs[new_row] = row_unique_idxs[row];
+        unique_idxs.move(row_unique_idxs[new_row], new_row);
+        ++new_row;
     }
-    delete[] data;
-    data = new_data;
 
-    unique_idxs_to_order = new_unique_idxs_to_order;
-    order_idxs_to_unique = new_order_idxs_to_unique;
-    --size;
-
-    return RC::SUCCESS;
+    row_unique_idxs.resize(size);
+    ranks.reset(size);
+    spatial_index.clear();
+    spatial_index.rebuild(storage, size);
 }
 
 SetImpl::~SetImpl()
 {
-    delete[] data;
     delete control_block;
 }
 
@@ -497,293 +563,425 @@ SetImpl::SetImpl()
 {
     control_block = SetImplControlBlock::createControlBlock(this);
 
-    capacity = 100;
-    data = new double[capacity];
-
+    // Chunks are allocated by the first insert or reserve
     size = 0;
     dim = 0;
-    last_vec_idx = 0;
+    default_norm = IVector::NORM::CHEBYSHEV;
+    default_tol = 0;
 }
 
-SetImpl::SetImpl(double const *const &other_data, size_t other_size, size_t other_dim,
-                 const std::map<size_t, size_t> &other_unique_map, const std::map<size_t, size_t> &other_order_map, size_t other_last_idx)
+SetImpl::SetImpl(const SetImpl &other) : ISet(), unique_idxs(other.unique_idxs), spatial_index(other.spatial_index)
 {
     control_block = SetImplControlBlock::createControlBlock(this);
 
-    capacity = other_size * other_dim;
-    data = new double[capacity];
-    for (size_t idx = 0; idx < other_size * other_dim; ++idx)
+    size = other.size;
+    dim = other.dim;
+    default_norm = other.default_norm;
+    default_tol = other.default_tol;
+
+    // Failure to allocate the chunks is found by clone
+    storage.useHugePages(other.storage.usesHugePages());
+    if (dim != 0)
     {
-        data[idx] = other_data[idx];
+        storage.setDim(dim);
+    }
+    if (!storage.reserve(size))
+    {
+        size = 0;
+        return;
     }
 
-    size = other_size;
-    dim = other_dim;
-    last_vec_idx = other_last_idx;
+    for (size_t row = 0, new_row = 0; row < other.ranks.rows(); ++row)
+    {
+        if (!other.ranks.isLive(row))
+        {
+            continue;
+        }
 
-    unique_idxs_to_order = other_unique_map;
-    order_idxs_to_unique = other_order_map;
-}
+        double const *src = other.storage.row(row);
+        double *dest = storage.row(new_row);
+        for (size_t idx = 0; idx < dim; ++idx)
+        {
+            dest[idx] = src[idx];
+        }
 
+        // Copy keeps the unique indices of the vectors
+        row_unique_idxs.push_back(other.row_unique_idxs[row]);
+        unique_idxs.move(other.row_unique_idxs[row], new_row);
+        ++new_row;
+    }
+    ranks.reset(size);
 
-ISet *ISet::makeIntersection(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol)
-{
-    if (op1->getDim() != op2->getDim())
+    // Index of other refers to its own row numbers
+    if (other.ranks.removed() != 0)
     {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
-        return nullptr;
+        spatial_index.clear();
+        spatial_index.rebuild(storage, size);
     }
+}
 
-    size_t dim = op1->getDim();
-    ISet *new_set = ISet::createSet();
 
-    IIterator *set1_iter = op1->getBegin();
-    for (; set1_iter->isValid(); set1_iter->next())
-    {
-        double *empty_data = new double[dim];
-        IVector *tmp_vec = IVector::createVector(dim, empty_data);
-        delete[] empty_data;
+namespace
+{
+    /*
+    * Reads rows of any ISet for the set algebra: straight from the storage of SetImpl, through a buffer from other
+    * implementations. Lookups go to the index of SetImpl and to findFirst of the others
+    */
+    class RowSource
+    {
+    public:
+        explicit RowSource(ISet const *set) :
+            set(set), impl(dynamic_cast<SetImpl const *>(set)), buffer(set->getDim()), row(set->getDim(), buffer.data())
+        {
+        }
 
-        RC err = set1_iter->getVectorCoords(tmp_vec);
-        if (err != RC::SUCCESS)
+        size_t size() const
         {
-            delete tmp_vec;
-            delete new_set;
-            delete set1_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
-            return nullptr;
+            return set->getSize();
         }
 
-        err = op2->findFirst(tmp_vec, n, tol);
-        if (err == RC::VECTOR_NOT_FOUND)
+        size_t dim() const
         {
-            delete tmp_vec;
-            continue;
+            return buffer.size();
         }
-        else if (err != RC::SUCCESS)
+
+        /*
+        * Rows and lookups of SetImpl are read-only and may be used by several threads at once
+        */
+        bool direct() const
         {
-            delete tmp_vec;
-            delete new_set;
-            delete set1_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
-            return nullptr;
+            return impl != nullptr;
         }
 
-        new_set->insert(tmp_vec, n, tol);
+        double const *get(size_t index)
+        {
+            if (impl != nullptr)
+            {
+                return impl->getRow(index);
+            }
+            return set->getCoords(index, &row) == RC::SUCCESS ? buffer.data() : nullptr;
+        }
 
-        delete tmp_vec;
-    }
-    delete set1_iter;
+        bool contains(double const *pat, IVector::NORM n, double tol) const
+        {
+            if (impl != nullptr)
+            {
+                return impl->findRow(pat, n, tol) != SetIndex::npos;
+            }
+            IVectorView view(dim(), pat);
+            return set->findFirst(&view, n, tol) == RC::SUCCESS;
+        }
 
-    IIterator *set2_iter = op2->getBegin();
-    for (; set2_iter->isValid(); set2_iter->next())
-    {
-        double *empty_data = new double[dim];
-        IVector *tmp_vec = IVector::createVector(dim, empty_data);
-        delete[] empty_data;
+    private:
+        ISet const *set;
+        SetImpl const *impl;
+        std::vector<double> buffer;
+        IMutableVectorView row;
+    };
 
-        RC err = set2_iter->getVectorCoords(tmp_vec);
-        if (err != RC::SUCCESS)
+    /*
+    * Checks of findFirst done once for the whole operation
+    */
+    RC checkOperands(ISet const *op1, ISet const *op2, IVector::NORM n, double tol)
+    {
+        if (op1 == nullptr || op2 == nullptr)
         {
-            delete tmp_vec;
-            delete new_set;
-            delete set2_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
-            return nullptr;
+            return RC::NULLPTR_ERROR;
+        }
+        if (op1->getDim() != op2->getDim())
+        {
+            return RC::MISMATCHING_DIMENSIONS;
+        }
+        if (n == IVector::NORM::AMOUNT || tol < 0)
+        {
+            return RC::INVALID_ARGUMENT;
         }
+        if (std::isnan(tol))
+        {
+            return RC::NOT_NUMBER;
+        }
+        if (std::isinf(tol))
+        {
+            return RC::INFINITY_OVERFLOW;
+        }
+        return RC::SUCCESS;
+    }
 
-        err = op1->findFirst(tmp_vec, n, tol);
+    // Rows looked up by one task of a parallel operation
+    const size_t rowsPerTask = 1024;
 
-        if (err == RC::VECTOR_NOT_FOUND)
+    /*
+    * Marks rows of src which have a row of other within tol, stops early at the first row whose mark equals stopAt
+    * if it is given. Returns false if some row could not be read
+    *
+    * Lookups are split among threads when asked to and both sets are SetImpl, other sets are read sequentially
+    */
+    bool matchRows(RowSource &src, RowSource const &other, IVector::NORM n, double tol, ISet::EXECUTION execution,
+                   std::vector<char> &marks, int stopAt = -1)
+    {
+        const size_t count = src.size();
+        marks.assign(count, 0);
+
+        if (execution == ISet::EXECUTION::PARALLEL && src.direct() && other.direct() && count > rowsPerTask)
         {
-            delete tmp_vec;
-            continue;
+            std::atomic<bool> stop(false);
+            std::atomic<bool> failed(false);
+
+            ThreadPool::run((count + rowsPerTask - 1) / rowsPerTask, [&](size_t task)
+            {
+                const size_t last = std::min(count, (task + 1) * rowsPerTask);
+                for (size_t idx = task * rowsPerTask; idx < last && !stop.load(std::memory_order_relaxed); ++idx)
+                {
+                    double const *row = src.get(idx);
+                    if (row == nullptr)
+                    {
+                        failed = true;
+                        stop = true;
+                        return;
+                    }
+
+                    marks[idx] = other.contains(row, n, tol);
+                    if (marks[idx] == stopAt)
+                    {
+                        stop = true;
+                    }
+                }
+            });
+            return !failed;
         }
-        else if (err != RC::SUCCESS)
+
+        for (size_t idx = 0; idx < count; ++idx)
         {
-            delete tmp_vec;
-            delete new_set;
-            delete set2_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
-            return nullptr;
+            double const *row = src.get(idx);
+            if (row == nullptr)
+            {
+                return false;
+            }
+
+            marks[idx] = other.contains(row, n, tol);
+            if (marks[idx] == stopAt)
+            {
+                break;
+            }
         }
+        return true;
+    }
 
-        new_set->insert(tmp_vec, n, tol);
+    /*
+    * Spatial join: appends rows of src which have (or have not, if matched is false) a row of other within tol,
+    * in the order of src. Rows within tol of a row already in dest are skipped like insert does
+    *
+    * Only the lookups in other run in parallel, rows are appended by the calling thread in order
+    */
+    RC joinInto(ISet *dest, RowSource &src, RowSource const &other, bool matched, IVector::NORM n, double tol,
+                ISet::EXECUTION execution)
+    {
+        std::vector<char> marks;
+        if (!matchRows(src, other, n, tol, execution, marks))
+        {
+            return RC::INDEX_OUT_OF_BOUND;
+        }
 
-        delete tmp_vec;
-    }
-    delete set2_iter;
+        RowSource result(dest);
+        for (size_t idx = 0; idx < marks.size(); ++idx)
+        {
+            if ((marks[idx] != 0) != matched)
+            {
+                continue;
+            }
 
-    return new_set;
-}
+            double const *row = src.get(idx);
+            if (row == nullptr)
+            {
+                return RC::INDEX_OUT_OF_BOUND;
+            }
+            if (result.contains(row, n, tol))
+            {
+                continue;
+            }
 
-ISet *ISet::makeUnion(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol)
-{
-    if (op1->getDim() != op2->getDim())
-    {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
-        return nullptr;
+            IVectorView view(src.dim(), row);
+            RC err = dest->insert(&view, n, tol);
+            if (err != RC::SUCCESS)
+            {
+                return err;
+            }
+        }
+        return RC::SUCCESS;
     }
 
-    size_t dim = op1->getDim();
-    ISet *new_set = op1->clone();
-
-    IIterator *set2_iter = op2->getBegin();
-    for (; set2_iter->isValid(); set2_iter->next())
+    /*
+    * Result of one or two joins into a new set or nullptr
+    */
+    ISet *join(ISet *dest, ISet const *op1, ISet const *op2, bool matched, bool both, IVector::NORM n, double tol,
+               ISet::EXECUTION execution)
     {
-        double *empty_data = new double[dim];
-        IVector *tmp_vec = IVector::createVector(dim, empty_data);
-        delete[] empty_data;
-
-        RC err = set2_iter->getVectorCoords(tmp_vec);
-        if (err != RC::SUCCESS)
+        if (dest == nullptr)
         {
-            delete tmp_vec;
-            delete new_set;
-            delete set2_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            ISet::getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
             return nullptr;
         }
 
-        err = new_set->findFirst(tmp_vec, n, tol);
-        if (err == RC::VECTOR_NOT_FOUND)
+        RowSource rows1(op1);
+        RowSource rows2(op2);
+        RC err = joinInto(dest, rows1, rows2, matched, n, tol, execution);
+        if (err == RC::SUCCESS && both)
         {
-            new_set->insert(tmp_vec, n, tol);
+            err = joinInto(dest, rows2, rows1, matched, n, tol, execution);
         }
-        else if (err != RC::SUCCESS)
+
+        if (err != RC::SUCCESS)
         {
-            delete tmp_vec;
-            delete new_set;
-            delete set2_iter;
-            getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            ISet::getLogger()->severe(err, __FILE__, __func__, __LINE__);
+            delete dest;
             return nullptr;
         }
-
-        delete tmp_vec;
+        return dest;
     }
-    delete set2_iter;
+}
 
-    return new_set;
+double const *SetImpl::getRow(size_t index) const
+{
+    return index < size ? storage.row(ranks.select(index)) : nullptr;
 }
 
-ISet *ISet::sub(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol)
+size_t SetImpl::findRow(double const *pat, IVector::NORM n, double tol) const
 {
-    if (op1->getDim() != op2->getDim())
+    return spatial_index.findAny(storage, pat, n, tol);
+}
+
+RC ISet::insertBatch(IVectorBatch const *const &batch, IVector::NORM n, double tol, RC *statuses)
+{
+    if (batch == nullptr)
     {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
-        return nullptr;
+        getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
+        return RC::NULLPTR_ERROR;
     }
 
-    size_t dim = op1->getDim();
-    ISet *new_set = ISet::createSet();
-
-    IIterator *set1_iter = op1->getBegin();
-    for (; set1_iter->isValid(); set1_iter->next())
+    // Columns of the batch are turned into rows
+    const size_t batch_dim = batch->getDim();
+    const size_t count = batch->getSize();
+    std::vector<double> rows(batch_dim * count);
+    for (size_t axis = 0; axis < batch_dim; ++axis)
     {
-        double *empty_data = new double[dim];
-        IVector *vec1 = IVector::createVector(dim, empty_data);
-        delete[] empty_data;
-
-        RC err = set1_iter->getVectorCoords(vec1);
-        if (err != RC::SUCCESS)
+        double const *column = batch->getColumn(axis);
+        for (size_t idx = 0; idx < count; ++idx)
         {
-            delete vec1;
-            delete set1_iter;
-            getLogger()->warning(err, __FILE__, __func__, __LINE__);
-            return new_set;
+            rows[idx * batch_dim + axis] = column[idx];
         }
+    }
 
-        err = op2->findFirst(vec1, n, tol);
+    return insertBatch(rows.data(), batch_dim, count, n, tol, statuses);
+}
 
-        if (err == RC::VECTOR_NOT_FOUND)
-        {
-            new_set->insert(vec1, n, tol);
-        }
-        else if (err != RC::SUCCESS)
-        {
-            getLogger()->warning(err, __FILE__, __func__, __LINE__);
-            delete vec1;
-            delete set1_iter;
-            return new_set;
-        }
+ISet *ISet::makeIntersection(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol,
+                             EXECUTION execution)
+{
+    RC err = checkOperands(op1, op2, n, tol);
+    if (err != RC::SUCCESS)
+    {
+        getLogger()->severe(err, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+
+    // Rows of op1 matching op2, then rows of op2 matching op1
+    return join(ISet::createSet(), op1, op2, true, true, n, tol, execution);
+}
 
-        delete vec1;
+ISet *ISet::makeUnion(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol,
+                      EXECUTION execution)
+{
+    RC err = checkOperands(op1, op2, n, tol);
+    if (err != RC::SUCCESS)
+    {
+        getLogger()->severe(err, __FILE__, __func__, __LINE__);
+        return nullptr;
     }
-    delete set1_iter;
 
+    ISet *new_set = op1->clone();
+    if (new_set == nullptr)
+    {
+        getLogger()->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+
+    // Rows of op2 without a match in op1, joinInto skips those matching rows of op2 added before them
+    RowSource rows1(op1);
+    RowSource rows2(op2);
+    err = joinInto(new_set, rows2, rows1, false, n, tol, execution);
+    if (err != RC::SUCCESS)
+    {
+        getLogger()->severe(err, __FILE__, __func__, __LINE__);
+        delete new_set;
+        return nullptr;
+    }
     return new_set;
 }
 
-ISet *ISet::symSub(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol)
+ISet *ISet::sub(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol,
+                EXECUTION execution)
 {
-    ISet *un = ISet::makeUnion(op1, op2, n, tol);
-    ISet *inter = ISet::makeIntersection(op1, op2, n, tol);
-    ISet *sub = ISet::sub(un, inter, n, tol);
+    RC err = checkOperands(op1, op2, n, tol);
+    if (err != RC::SUCCESS)
+    {
+        getLogger()->severe(err, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
 
-    delete un;
-    delete inter;
-    return sub;
+    return join(ISet::createSet(), op1, op2, false, false, n, tol, execution);
 }
 
-bool ISet::equals(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol)
+ISet *ISet::symSub(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol,
+                   EXECUTION execution)
 {
-    if (op1->getSize() != op2->getSize())
+    RC err = checkOperands(op1, op2, n, tol);
+    if (err != RC::SUCCESS)
     {
-        getLogger()->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
-        return false;
+        getLogger()->severe(err, __FILE__, __func__, __LINE__);
+        return nullptr;
     }
 
-    return subSet(op1, op2, n, tol);
+    // Rows of op1 without a match in op2, then rows of op2 without a match in op1, no intermediate sets
+    return join(ISet::createSet(), op1, op2, false, true, n, tol, execution);
 }
 
-bool ISet::subSet(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol)
+bool ISet::equals(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol,
+                  EXECUTION execution)
 {
-    if (op1->getDim() != op2->getDim())
+    if (op1 == nullptr || op2 == nullptr)
     {
-        getLogger()->severe(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        getLogger()->severe(RC::NULLPTR_ERROR, __FILE__, __func__, __LINE__);
         return false;
     }
 
-    size_t dim = op1->getDim();
-
-    IIterator *vec1_iter = op1->getBegin();
-    for (; vec1_iter != nullptr && vec1_iter->isValid(); vec1_iter->next())
+    if (op1->getSize() != op2->getSize())
     {
-        double *empty_data = new double[dim];
-        IVector *vec1 = IVector::createVector(dim, empty_data);
-        delete[] empty_data;
-
-        RC err = vec1_iter->getVectorCoords(vec1);
-
-        if (err != RC::SUCCESS)
-        {
-            delete vec1;
-            delete vec1_iter;
-            getLogger()->warning(err, __FILE__, __func__, __LINE__);
-            return false;
-        }
-
-        err = op2->findFirst(vec1, n, tol);
+        getLogger()->warning(RC::MISMATCHING_DIMENSIONS, __FILE__, __func__, __LINE__);
+        return false;
+    }
 
-        if (err == RC::VECTOR_NOT_FOUND)
-        {
-            delete vec1;
-            delete vec1_iter;
-            return false;
-        }
-        else if (err != RC::SUCCESS)
-        {
-            delete vec1;
-            delete vec1_iter;
-            getLogger()->warning(err, __FILE__, __func__, __LINE__);
-            return false;
-        }
+    return subSet(op1, op2, n, tol, execution);
+}
 
-        delete vec1;
+bool ISet::subSet(ISet const *const &op1, ISet const *const &op2, IVector::NORM n, double tol,
+                  EXECUTION execution)
+{
+    RC err = checkOperands(op1, op2, n, tol);
+    if (err != RC::SUCCESS)
+    {
+        getLogger()->severe(err, __FILE__, __func__, __LINE__);
+        return false;
     }
-    delete vec1_iter;
 
-    return true;
+    // Lookups stop at the first row of op1 without a match
+    RowSource rows1(op1);
+    RowSource rows2(op2);
+    std::vector<char> marks;
+    if (!matchRows(rows1, rows2, n, tol, execution, marks, 0))
+    {
+        return false;
+    }
+    return std::find(marks.begin(), marks.end(), 0) == marks.end();
 }
 
 RC ISet::IIterator::setLogger(ILogger *const pLogger)
@@ -0,0 +1,275 @@
+#include "../myHeaders/SetIndex.h"
+#include "../include/IVectorView.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace
+{
+    // Subtrees this small are scanned instead of being split further
+    const size_t leafSize = 8;
+}
+
+void SetIndex::useCells(double cellSize)
+{
+    cells = true;
+    cell = cellSize;
+}
+
+bool SetIndex::usesCells() const
+{
+    return cells;
+}
+
+void SetIndex::clear()
+{
+    levels.clear();
+    buckets.clear();
+    erased.clear();
+    count = 0;
+}
+
+void SetIndex::reserve(size_t rowCount)
+{
+    // Room grows at least twice, so that many small batches do not reallocate every time
+    if (erased.capacity() < count + rowCount)
+        erased.reserve(std::max(count + rowCount, 2 * erased.capacity()));
+    if (cells && buckets.bucket_count() < buckets.size() + rowCount)
+        buckets.reserve(std::max(buckets.size() + rowCount, 2 * buckets.size()));
+}
+
+int64_t SetIndex::cellOf(double coord) const
+{
+    // Equal rows share the bit pattern, up to the sign of zero
+    if (cell == 0)
+    {
+        const double normalized = coord + 0.0;
+        int64_t bits;
+        memcpy(&bits, &normalized, sizeof(bits));
+        return bits;
+    }
+
+    // Far cells are clamped together, which only adds candidates
+    const double limit = 4.0e18;
+    const double idx = std::floor(coord / cell);
+    return static_cast<int64_t>(std::max(-limit, std::min(limit, idx)));
+}
+
+uint64_t SetIndex::mix(uint64_t hash, int64_t cellIdx)
+{
+    hash ^= static_cast<uint64_t>(cellIdx) + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+    return hash;
+}
+
+uint64_t SetIndex::hashOf(double const *coords, size_t dim) const
+{
+    uint64_t hash = 0;
+    for (size_t axis = 0; axis < dim; ++axis)
+        hash = mix(hash, cellOf(coords[axis]));
+    return hash;
+}
+
+void SetIndex::insert(RowStore const &store, size_t row)
+{
+    const size_t dim = store.getDim();
+    ++count;
+    erased.push_back(0);
+    if (cells && dim > maxCellDim)
+    {
+        // Too many neighbouring cells to probe, the rows indexed so far go to the k-d trees
+        cells = false;
+        rebuild(store, count);
+        return;
+    }
+
+    if (cells)
+    {
+        buckets.emplace(hashOf(store.row(row), dim), row);
+        return;
+    }
+
+    std::vector<size_t> carry(1, row);
+
+    // Erased rows are left out of the merged tree
+    size_t level = 0;
+    for (; level < levels.size() && !levels[level].empty(); ++level)
+    {
+        for (size_t idx : levels[level])
+            if (erased[idx] == 0)
+                carry.push_back(idx);
+        levels[level].clear();
+    }
+
+    if (level == levels.size())
+        levels.emplace_back();
+
+    build(carry, 0, carry.size(), 0, store);
+    levels[level].swap(carry);
+}
+
+void SetIndex::rebuild(RowStore const &store, size_t rowCount)
+{
+    const size_t dim = store.getDim();
+    std::vector<char> kept;
+    kept.swap(erased);
+    kept.resize(rowCount, 0);
+
+    clear();
+    count = rowCount;
+    erased.swap(kept);
+    if (cells && dim > maxCellDim)
+        cells = false;
+
+    std::vector<size_t> live;
+    live.reserve(count);
+    for (size_t row = 0; row < count; ++row)
+        if (erased[row] == 0)
+            live.push_back(row);
+
+    if (cells)
+    {
+        buckets.reserve(live.size());
+        for (size_t row : live)
+            buckets.emplace(hashOf(store.row(row), dim), row);
+        return;
+    }
+
+    // Level k gets the rows of bit k of their count, which is the state as many inserts would have left
+    size_t next = 0;
+    for (size_t level = 0; (live.size() >> level) != 0; ++level)
+    {
+        levels.emplace_back();
+        if (((live.size() >> level) & 1) == 0)
+            continue;
+
+        std::vector<size_t> &rows = levels.back();
+        rows.assign(live.begin() + next, live.begin() + next + (size_t(1) << level));
+        next += rows.size();
+
+        build(rows, 0, rows.size(), 0, store);
+    }
+}
+
+void SetIndex::erase(size_t row)
+{
+    if (row < count)
+        erased[row] = 1;
+}
+
+void SetIndex::build(std::vector<size_t> &rows, size_t lo, size_t hi, size_t depth, RowStore const &store)
+{
+    const size_t dim = store.getDim();
+    if (hi - lo <= leafSize || dim == 0)
+        return;
+
+    const size_t mid = lo + (hi - lo) / 2;
+    const size_t axis = depth % dim;
+
+    std::nth_element(rows.begin() + lo, rows.begin() + mid, rows.begin() + hi,
+                     [&](size_t a, size_t b) { return store.row(a)[axis] < store.row(b)[axis]; });
+
+    build(rows, lo, mid, depth + 1, store);
+    build(rows, mid + 1, hi, depth + 1, store);
+}
+
+bool SetIndex::visit(size_t row, Query &query)
+{
+    if (query.first && row >= query.found)
+        return false;
+    if (query.erased[row] != 0)
+        return false;
+
+    IVectorView pat(query.dim, query.pat);
+    IVectorView cur(query.dim, query.store->row(row));
+    if (!IVector::withinTolerance(&pat, &cur, query.n, query.tol))
+        return false;
+
+    query.found = row;
+    return !query.first;
+}
+
+bool SetIndex::search(std::vector<size_t> const &rows, size_t lo, size_t hi, size_t depth, Query &query)
+{
+    if (hi - lo <= leafSize || query.dim == 0)
+    {
+        for (size_t idx = lo; idx < hi; ++idx)
+            if (visit(rows[idx], query))
+                return true;
+        return false;
+    }
+
+    const size_t mid = lo + (hi - lo) / 2;
+    const size_t axis = depth % query.dim;
+    const double split = query.store->row(rows[mid])[axis];
+    const double coord = query.pat[axis];
+
+    // Rows before mid are not greater than split along axis, rows after it are not less. Differences are rounded
+    // like in the exact check, which is monotone, so a side is skipped only when even split is farther than tol
+    if (visit(rows[mid], query))
+        return true;
+    if (!(coord - split > query.tol) && search(rows, lo, mid, depth + 1, query))
+        return true;
+    return !(split - coord > query.tol) && search(rows, mid + 1, hi, depth + 1, query);
+}
+
+bool SetIndex::probe(int64_t const *lo, int64_t const *hi, size_t axis, uint64_t hash, Query &query) const
+{
+    if (axis == query.dim)
+    {
+        auto range = buckets.equal_range(hash);
+        for (auto it = range.first; it != range.second; ++it)
+            if (visit(it->second, query))
+                return true;
+        return false;
+    }
+
+    for (int64_t cellIdx = lo[axis]; cellIdx <= hi[axis]; ++cellIdx)
+        if (probe(lo, hi, axis + 1, mix(hash, cellIdx), query))
+            return true;
+    return false;
+}
+
+size_t SetIndex::find(RowStore const &store, double const *pat, IVector::NORM n, double tol, bool first) const
+{
+    const size_t dim = store.getDim();
+    Query query = {&store, dim, pat, n, tol, first, erased.data(), npos};
+
+    if (cells && tol <= cell && dim <= maxCellDim)
+    {
+        // Rows within tol of the pattern lie in at most three cells along every axis, which are widened by an ulp
+        // against the rounding of the bounds
+        int64_t lo[maxCellDim], hi[maxCellDim];
+        for (size_t axis = 0; axis < dim; ++axis)
+        {
+            lo[axis] = cell == 0 ? cellOf(pat[axis]) : cellOf(std::nextafter(pat[axis] - tol, -HUGE_VAL));
+            hi[axis] = cell == 0 ? cellOf(pat[axis]) : cellOf(std::nextafter(pat[axis] + tol, HUGE_VAL));
+        }
+
+        probe(lo, hi, 0, 0, query);
+        return query.found;
+    }
+
+    if (cells)
+    {
+        for (size_t row = 0; row < count; ++row)
+            if (visit(row, query))
+                break;
+        return query.found;
+    }
+
+    for (std::vector<size_t> const &rows : levels)
+        if (search(rows, 0, rows.size(), 0, query))
+            break;
+
+    return query.found;
+}
+
+size_t SetIndex::findFirst(RowStore const &store, double const *pat, IVector::NORM n, double tol) const
+{
+    return find(store, pat, n, tol, true);
+}
+
+size_t SetIndex::findAny(RowStore const &store, double const *pat, IVector::NORM n, double tol) const
+{
+    return find(store, pat, n, tol, false);
+}
@@ -1,12 +1,12 @@
 #include "../include/ISet.h"
 #include "../myHeaders/SetImpl.h"
-#include <stdexcept>
+#include <utility>
 
-SetImpl::IteratorImpl::IteratorImpl(SetImplControlBlock *const &cb, size_t index, IVector *vector)
+SetImpl::IteratorImpl::IteratorImpl(SetImplControlBlock *const &cb, size_t index, VectorPtr vector)
 {
     control_block = cb;
     cur_unique_idx = index;
-    cur_vector = vector;
+    cur_vector = std::move(vector);
     valid = true;
 }
 
@@ -36,7 +36,14 @@ ISet::IIterator *SetImpl::IteratorImpl::getPrevious(size_t indexInc) const
 
 ISet::IIterator *SetImpl::IteratorImpl::clone() const
 {
-    return new (std::nothrow) IteratorImpl(control_block, cur_unique_idx, cur_vector->clone());
+    VectorPtr vector = cur_vector->clonePtr();
+    if (vector == nullptr)
+    {
+        logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
+        return nullptr;
+    }
+    // Vector is moved only if the iterator has been allocated, otherwise it is freed here
+    return new (std::nothrow) IteratorImpl(control_block, cur_unique_idx, std::move(vector));
 }
 
 RC SetImpl::IteratorImpl::setLogger(ILogger *const pLogger)
@@ -52,7 +59,7 @@ RC SetImpl::IteratorImpl::setLogger(ILogger *const pLogger)
 
 RC SetImpl::IteratorImpl::next(size_t indexInc)
 {
-    RC err = control_block->getNext(cur_vector, cur_unique_idx, indexInc);
+    RC err = control_block->getNext(cur_vector.get(), cur_unique_idx, indexInc);
     if (err == RC::INDEX_OUT_OF_BOUND)
     {
         valid = false;
@@ -62,7 +69,7 @@ RC SetImpl::IteratorImpl::next(size_t indexInc)
 
 RC SetImpl::IteratorImpl::previous(size_t indexInc)
 {
-    RC err = control_block->getPrevious(cur_vector, cur_unique_idx, indexInc);
+    RC err = control_block->getPrevious(cur_vector.get(), cur_unique_idx, indexInc);
     if (err == RC::INDEX_OUT_OF_BOUND)
     {
         valid = false;
@@ -78,12 +85,12 @@ bool SetImpl::IteratorImpl::isValid() const
 
 RC SetImpl::IteratorImpl::makeBegin()
 {
-    return control_block->getBegin(cur_vector, cur_unique_idx);
+    return control_block->getBegin(cur_vector.get(), cur_unique_idx);
 }
 
 RC SetImpl::IteratorImpl::makeEnd()
 {
-    return control_block->getEnd(cur_vector, cur_unique_idx);
+    return control_block->getEnd(cur_vector.get(), cur_unique_idx);
 }
 
 RC SetImpl::IteratorImpl::getVectorCopy(IVector *&val) const
@@ -103,10 +110,7 @@ RC SetImpl::IteratorImpl::getVectorCoords(IVector *const &val) const
     return val->setData(cur_vector->getDim(), cur_vector->getData());
 }
 
-SetImpl::IteratorImpl::~IteratorImpl()
-{
-    delete cur_vector;
-}
+SetImpl::IteratorImpl::~IteratorImpl() = default;
 
 ISet::IIterator::~IIterator() = default;
 
@@ -118,17 +122,16 @@ ISet::IIterator *SetImpl::getIterator(size_t index) const
         return nullptr;
     }
 
-    IVector *vec;
+    VectorPtr vec;
     RC err = getCopy(index, vec);
     if (err != RC::SUCCESS)
     {
         logger->severe(err, __FILE__, __func__, __LINE__);
         return nullptr;
     }
-    IteratorImpl *iter = new (std::nothrow) IteratorImpl(control_block, order_idxs_to_unique.at(index), vec);
+    IteratorImpl *iter = new (std::nothrow) IteratorImpl(control_block, row_unique_idxs[ranks.select(index)], std::move(vec));
     if (iter == nullptr)
     {
-        delete vec;
         logger->severe(RC::ALLOCATION_ERROR, __FILE__, __func__, __LINE__);
         return nullptr;
     }
@@ -148,38 +151,62 @@ ISet::IIterator *SetImpl::getEnd() const
 
 RC SetImpl::getNextByUniqueIndex(IVector *const &vec, size_t &index, size_t indexInc)
 {
-    try
+    const size_t cur_row = unique_idxs.find(index);
+    if (cur_row == SlotMap::npos)
     {
-        index = order_idxs_to_unique.at(unique_idxs_to_order.at(index) + indexInc);
+        return RC::INDEX_OUT_OF_BOUND;
     }
-    catch (std::out_of_range)
+
+    const size_t position = ranks.rank(cur_row);
+    if (indexInc >= size - position)
     {
         return RC::INDEX_OUT_OF_BOUND;
     }
-    return getCoords(unique_idxs_to_order.at(index), vec);
+
+    const size_t row = ranks.select(position + indexInc);
+    index = row_unique_idxs[row];
+    return vec->setData(dim, storage.row(row));
 }
 
 RC SetImpl::getPrevByUniqueIndex(IVector *const &vec, size_t &index, size_t indexInc)
 {
-    try
+    const size_t cur_row = unique_idxs.find(index);
+    if (cur_row == SlotMap::npos)
     {
-        index = order_idxs_to_unique.at(unique_idxs_to_order.at(index) - indexInc);
+        return RC::INDEX_OUT_OF_BOUND;
     }
-    catch (std::out_of_range)
+
+    const size_t position = ranks.rank(cur_row);
+    if (indexInc > position)
     {
         return RC::INDEX_OUT_OF_BOUND;
     }
-    return getCoords(unique_idxs_to_order.at(index), vec);
+
+    const size_t row = ranks.select(position - indexInc);
+    index = row_unique_idxs[row];
+    return vec->setData(dim, storage.row(row));
 }
 
 RC SetImpl::getFirstByUniqueIndex(IVector *const &vec, size_t &index)
 {
-    index = order_idxs_to_unique.at(0);
-    return getCoords(0, vec);
+    if (size == 0)
+    {
+        return RC::SOURCE_SET_EMPTY;
+    }
+
+    const size_t row = ranks.select(0);
+    index = row_unique_idxs[row];
+    return vec->setData(dim, storage.row(row));
 }
 
 RC SetImpl::getLastByUniqueIndex(IVector *const &vec, size_t &index)
 {
-    index = order_idxs_to_unique.at(size - 1);
-    return getCoords(size - 1, vec);
+    if (size == 0)
+    {
+        return RC::SOURCE_SET_EMPTY;
+    }
+
+    const size_t row = ranks.select(size - 1);
+    index = row_unique_idxs[row];
+    return vec->setData(dim, storage.row(row));
 }
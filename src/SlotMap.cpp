@@ -0,0 +1,79 @@
+#include "../myHeaders/SlotMap.h"
+#include <algorithm>
+
+namespace
+{
+    uint32_t slotOf(size_t key)
+    {
+        return static_cast<uint32_t>(key);
+    }
+
+    uint32_t generationOf(size_t key)
+    {
+        return static_cast<uint32_t>(static_cast<uint64_t>(key) >> 32);
+    }
+}
+
+void SlotMap::clear()
+{
+    slots.clear();
+    free_slots.clear();
+}
+
+void SlotMap::reserve(size_t count)
+{
+    if (slots.capacity() < count)
+    {
+        slots.reserve(std::max(count, 2 * slots.capacity()));
+    }
+}
+
+size_t SlotMap::insert(size_t row)
+{
+    uint32_t slot;
+    if (!free_slots.empty())
+    {
+        slot = free_slots.back();
+        free_slots.pop_back();
+    }
+    else
+    {
+        slot = static_cast<uint32_t>(slots.size());
+        slots.push_back(Slot{0, 0, false});
+    }
+
+    slots[slot].row = row;
+    slots[slot].used = true;
+    return static_cast<size_t>(static_cast<uint64_t>(slots[slot].generation) << 32 | slot);
+}
+
+void SlotMap::erase(size_t key)
+{
+    if (find(key) == npos)
+    {
+        return;
+    }
+
+    Slot &slot = slots[slotOf(key)];
+    slot.used = false;
+    ++slot.generation;
+    free_slots.push_back(slotOf(key));
+}
+
+void SlotMap::move(size_t key, size_t row)
+{
+    if (find(key) != npos)
+    {
+        slots[slotOf(key)].row = row;
+    }
+}
+
+size_t SlotMap::find(size_t key) const
+{
+    const uint32_t slot = slotOf(key);
+    if (slot >= slots.size() || !slots[slot].used || slots[slot].generation != generationOf(key))
+    {
+        return npos;
+    }
+    return slots[slot].row;
+}
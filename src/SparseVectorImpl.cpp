@@ -0,0 +1,417 @@
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <new>
+#include "../myHeaders/SparseVectorImpl.h"
+#include "../myHeaders/VectorKernels.h"
+
+ILogger* SparseVectorImpl::logger = nullptr;
+
+///////////////////ISparseVector/////////////////
+
+RC ISparseVector::setLogger(ILogger* const logger)
+{
+    return SparseVectorImpl::setLogger(logger);
+}
+
+ILogger* ISparseVector::getLogger()
+{
+    return SparseVectorImpl::getLogger();
+}
+
+ISparseVector* ISparseVector::createVector(size_t dim, size_t nnz, size_t const* indices, double const* values)
+{
+    if (nnz != 0 && (indices == nullptr || values == nullptr))
+    {
+        SparseVectorImpl::log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    for (size_t k = 0; k < nnz; ++k)
+    {
+        if (indices[k] >= dim || (k != 0 && indices[k] <= indices[k - 1]))
+        {
+            SparseVectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return nullptr;
+        }
+
+        if (!std::isfinite(values[k]))
+        {
+            SparseVectorImpl::log(RC::NOT_NUMBER, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return nullptr;
+        }
+    }
+
+    SparseVectorImpl* vec = SparseVectorImpl::allocate(dim, nnz);
+    if (vec == nullptr)
+    {
+        SparseVectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    for (size_t k = 0; k < nnz; ++k)
+        if (values[k] != 0)
+            vec->append(indices[k], values[k]);
+
+    return vec;
+}
+
+ISparseVector* ISparseVector::createVector(IVector const* const& vec)
+{
+    if (vec == nullptr)
+    {
+        SparseVectorImpl::log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    double const* coords = vec->getData();
+    const size_t dim = vec->getDim();
+
+    size_t nnz = 0;
+    for (size_t idx = 0; idx < dim; ++idx)
+        nnz += coords[idx] != 0;
+
+    SparseVectorImpl* result = SparseVectorImpl::allocate(dim, nnz);
+    if (result == nullptr)
+    {
+        SparseVectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    for (size_t idx = 0; idx < dim; ++idx)
+        if (coords[idx] != 0)
+            result->append(idx, coords[idx]);
+
+    return result;
+}
+
+double ISparseVector::dot(ISparseVector const* const& op1, IVector const* const& op2)
+{
+    if (!op1 || !op2 || op1->getDim() != op2->getDim())
+        return std::numeric_limits<double>::quiet_NaN();
+
+    const double result = VectorKernels::get().gatherDot(op1->getValues(), op1->getIndices(), op2->getData(),
+                                                         op1->getNonZeroCount());
+
+    if (!std::isfinite(result))
+    {
+        SparseVectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return result;
+}
+
+double ISparseVector::dot(ISparseVector const* const& op1, ISparseVector const* const& op2)
+{
+    if (!op1 || !op2 || op1->getDim() != op2->getDim())
+        return std::numeric_limits<double>::quiet_NaN();
+
+    size_t const* idx1 = op1->getIndices();
+    size_t const* idx2 = op2->getIndices();
+    double const* val1 = op1->getValues();
+    double const* val2 = op2->getValues();
+    const size_t nnz1 = op1->getNonZeroCount();
+    const size_t nnz2 = op2->getNonZeroCount();
+
+    double result = 0;
+    size_t k1 = 0, k2 = 0;
+    while (k1 < nnz1 && k2 < nnz2)
+    {
+        if (idx1[k1] < idx2[k2])
+            ++k1;
+        else if (idx2[k2] < idx1[k1])
+            ++k2;
+        else
+            result += val1[k1++] * val2[k2++];
+    }
+
+    if (!std::isfinite(result))
+    {
+        SparseVectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return result;
+}
+
+ISparseVector::~ISparseVector() = default;
+
+///////////////////SparseVectorImpl/////////////////
+
+RC SparseVectorImpl::setLogger(ILogger* const pLogger)
+{
+    if (pLogger == nullptr)
+        return RC::NULLPTR_ERROR;
+
+    logger = pLogger;
+    return RC::SUCCESS;
+}
+
+ILogger* SparseVectorImpl::getLogger()
+{
+    return logger;
+}
+
+void SparseVectorImpl::log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line)
+{
+    if (logger != nullptr)
+        logger->log(code, level, srcfile, function, line);
+}
+
+SparseVectorImpl* SparseVectorImpl::allocate(size_t dim, size_t capacity)
+{
+    size_t* indices = nullptr;
+    double* values = nullptr;
+
+    if (capacity != 0)
+    {
+        indices = new (std::nothrow) size_t[capacity];
+        values = new (std::nothrow) double[capacity];
+    }
+
+    SparseVectorImpl* vec = nullptr;
+    if (capacity == 0 || (indices != nullptr && values != nullptr))
+        vec = new (std::nothrow) SparseVectorImpl(dim, capacity, indices, values);
+
+    if (vec == nullptr)
+    {
+        delete[] indices;
+        delete[] values;
+    }
+
+    return vec;
+}
+
+SparseVectorImpl::SparseVectorImpl(size_t dim, size_t capacity, size_t* indices, double* values) :
+    dimension(dim), nnz(0), capacity(capacity), indices(indices), values(values)
+{
+}
+
+SparseVectorImpl::~SparseVectorImpl()
+{
+    delete[] indices;
+    delete[] values;
+}
+
+size_t SparseVectorImpl::sizeAllocated() const
+{
+    return sizeof(SparseVectorImpl) + capacity * (sizeof(size_t) + sizeof(double));
+}
+
+void SparseVectorImpl::append(size_t index, double value)
+{
+    indices[nnz] = index;
+    values[nnz] = value;
+    ++nnz;
+}
+
+RC SparseVectorImpl::reserve(size_t required)
+{
+    if (required <= capacity)
+        return RC::SUCCESS;
+
+    const size_t grown = required < 2 * capacity ? 2 * capacity : required;
+    size_t* newIndices = new (std::nothrow) size_t[grown];
+    double* newValues = new (std::nothrow) double[grown];
+    if (newIndices == nullptr || newValues == nullptr)
+    {
+        delete[] newIndices;
+        delete[] newValues;
+        return RC::ALLOCATION_ERROR;
+    }
+
+    if (nnz != 0)
+    {
+        memcpy(newIndices, indices, nnz * sizeof(size_t));
+        memcpy(newValues, values, nnz * sizeof(double));
+    }
+
+    delete[] indices;
+    delete[] values;
+    indices = newIndices;
+    values = newValues;
+    capacity = grown;
+    return RC::SUCCESS;
+}
+
+size_t SparseVectorImpl::lowerBound(size_t index) const
+{
+    size_t lo = 0, hi = nnz;
+    while (lo < hi)
+    {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (indices[mid] < index)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    return lo;
+}
+
+ISparseVector* SparseVectorImpl::clone() const
+{
+    return ISparseVector::createVector(dimension, nnz, indices, values);
+}
+
+IVector* SparseVectorImpl::toVector() const
+{
+    double* buffer = new (std::nothrow) double[dimension];
+    if (buffer == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    memset(buffer, 0, dimension * sizeof(double));
+    for (size_t k = 0; k < nnz; ++k)
+        buffer[indices[k]] = values[k];
+
+    IVector* result = IVector::createVector(dimension, buffer);
+    delete[] buffer;
+
+    return result;
+}
+
+size_t SparseVectorImpl::getDim() const
+{
+    return dimension;
+}
+
+size_t SparseVectorImpl::getNonZeroCount() const
+{
+    return nnz;
+}
+
+size_t const* SparseVectorImpl::getIndices() const
+{
+    return indices;
+}
+
+double const* SparseVectorImpl::getValues() const
+{
+    return values;
+}
+
+RC SparseVectorImpl::getCord(size_t index, double& val) const
+{
+    if (index >= dimension)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    const size_t pos = lowerBound(index);
+    val = pos < nnz && indices[pos] == index ? values[pos] : 0;
+    return RC::SUCCESS;
+}
+
+RC SparseVectorImpl::setCord(size_t index, double val)
+{
+    if (index >= dimension)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    if (!std::isfinite(val))
+    {
+        log(RC::NOT_NUMBER, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NOT_NUMBER;
+    }
+
+    const size_t pos = lowerBound(index);
+    const bool stored = pos < nnz && indices[pos] == index;
+
+    if (stored && val != 0)
+    {
+        values[pos] = val;
+    }
+    else if (stored)
+    {
+        memmove(indices + pos, indices + pos + 1, (nnz - pos - 1) * sizeof(size_t));
+        memmove(values + pos, values + pos + 1, (nnz - pos - 1) * sizeof(double));
+        --nnz;
+    }
+    else if (val != 0)
+    {
+        if (reserve(nnz + 1) != RC::SUCCESS)
+        {
+            log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return RC::ALLOCATION_ERROR;
+        }
+
+        memmove(indices + pos + 1, indices + pos, (nnz - pos) * sizeof(size_t));
+        memmove(values + pos + 1, values + pos, (nnz - pos) * sizeof(double));
+        indices[pos] = index;
+        values[pos] = val;
+        ++nnz;
+    }
+
+    return RC::SUCCESS;
+}
+
+RC SparseVectorImpl::scale(double multiplier)
+{
+    if (!std::isfinite(multiplier))
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    if (!kernels.scaleIsFinite(values, multiplier, nnz))
+    {
+        log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INFINITY_OVERFLOW;
+    }
+
+    kernels.scale(values, values, multiplier, nnz);
+
+    // Products may underflow to zero, which are not stored
+    size_t kept = 0;
+    for (size_t k = 0; k < nnz; ++k)
+        if (values[k] != 0)
+        {
+            indices[kept] = indices[k];
+            values[kept] = values[k];
+            ++kept;
+        }
+    nnz = kept;
+
+    return RC::SUCCESS;
+}
+
+double SparseVectorImpl::norm(IVector::NORM n) const
+{
+    // Coordinates which are not stored are zeros, they add nothing to any norm
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    double result = 0;
+
+    switch (n)
+    {
+        case IVector::NORM::FIRST:
+            result = kernels.sumAbs(values, nnz);
+            break;
+
+        case IVector::NORM::SECOND:
+            result = sqrt(kernels.sumSquares(values, nnz));
+            break;
+
+        case IVector::NORM::CHEBYSHEV:
+            result = kernels.maxAbs(values, nnz);
+            break;
+
+        default:
+            log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    if (!std::isfinite(result))
+    {
+        log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    return result;
+}
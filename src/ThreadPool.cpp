@@ -0,0 +1,173 @@
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include "../myHeaders/ThreadPool.h"
+
+namespace
+{
+    /*
+    * Loop shared by the workers, indices are handed out one by one through next
+    */
+    struct Job
+    {
+        const std::function<void(size_t)>* task = nullptr;
+        size_t count = 0;
+        std::atomic<size_t> next{0};
+    };
+
+    // Set for worker threads, loops started by their tasks run inline
+    thread_local bool insideWorker = false;
+
+    class Pool
+    {
+    public:
+        ~Pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            wake.notify_all();
+
+            for (std::thread& worker : workers)
+                worker.join();
+        }
+
+        void setThreadCount(size_t count)
+        {
+            threadCount.store(count, std::memory_order_relaxed);
+        }
+
+        size_t getThreadCount() const
+        {
+            const size_t count = threadCount.load(std::memory_order_relaxed);
+            if (count != 0)
+                return count;
+
+            return std::max<size_t>(std::thread::hardware_concurrency(), 1);
+        }
+
+        void run(size_t count, const std::function<void(size_t)>& task)
+        {
+            const size_t threads = std::min(getThreadCount(), count);
+
+            std::unique_lock<std::mutex> busy(runMutex, std::defer_lock);
+            if (threads <= 1 || insideWorker || !busy.try_lock() || !startWorkers(threads - 1))
+            {
+                for (size_t idx = 0; idx < count; ++idx)
+                    task(idx);
+                return;
+            }
+
+            Job job;
+            job.task = &task;
+            job.count = count;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                current = &job;
+                participants = std::min(threads - 1, workers.size());
+                remaining = participants;
+                ++generation;
+            }
+            wake.notify_all();
+
+            work(job);
+
+            // Workers may still hold the job after the last index is taken, so wait for them to leave it
+            std::unique_lock<std::mutex> lock(mutex);
+            finished.wait(lock, [this] { return remaining == 0; });
+            current = nullptr;
+        }
+
+    private:
+        static void work(Job& job)
+        {
+            for (size_t idx = job.next.fetch_add(1); idx < job.count; idx = job.next.fetch_add(1))
+                (*job.task)(idx);
+        }
+
+        /*
+        * Makes sure that at least count workers exist, returns false if none could be started
+        */
+        bool startWorkers(size_t count)
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            while (workers.size() < count)
+            {
+                try
+                {
+                    workers.emplace_back(&Pool::loop, this, workers.size());
+                }
+                catch (const std::system_error&)
+                {
+                    break;
+                }
+            }
+            return !workers.empty();
+        }
+
+        void loop(size_t index)
+        {
+            insideWorker = true;
+            size_t seen = 0;
+
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true)
+            {
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping)
+                    return;
+
+                seen = generation;
+                // Workers above the requested count sit this loop out
+                if (index >= participants)
+                    continue;
+
+                Job* job = current;
+                lock.unlock();
+                work(*job);
+                lock.lock();
+
+                if (--remaining == 0)
+                    finished.notify_one();
+            }
+        }
+
+        std::mutex runMutex; // one loop at a time
+        std::mutex mutex;
+        std::condition_variable wake;
+        std::condition_variable finished;
+        std::vector<std::thread> workers;
+        Job* current = nullptr;
+        size_t generation = 0;
+        size_t participants = 0; // workers taking part in the current loop
+        size_t remaining = 0;    // participants which have not left it yet
+        bool stopping = false;
+        std::atomic<size_t> threadCount{0};
+    };
+
+    Pool& pool()
+    {
+        static Pool instance;
+        return instance;
+    }
+}
+
+void ThreadPool::setThreadCount(size_t count)
+{
+    pool().setThreadCount(count);
+}
+
+size_t ThreadPool::getThreadCount()
+{
+    return pool().getThreadCount();
+}
+
+void ThreadPool::run(size_t count, const std::function<void(size_t)>& task)
+{
+    pool().run(count, task);
+}
@@ -0,0 +1,394 @@
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <new>
+#include "../myHeaders/VectorBatchImpl.h"
+#include "../myHeaders/VectorKernels.h"
+#include "../myHeaders/VectorOps.h"
+
+ILogger* VectorBatchImpl::logger = nullptr;
+
+///////////////////IVectorBatch/////////////////
+
+RC IVectorBatch::setLogger(ILogger* const logger)
+{
+    return VectorBatchImpl::setLogger(logger);
+}
+
+ILogger* IVectorBatch::getLogger()
+{
+    return VectorBatchImpl::getLogger();
+}
+
+IVectorBatch* IVectorBatch::createBatch(size_t dim, size_t count)
+{
+    if (dim == 0)
+    {
+        VectorBatchImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    VectorBatchImpl* batch = VectorBatchImpl::allocate(dim, count);
+    if (batch == nullptr)
+        VectorBatchImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return batch;
+}
+
+IVectorBatch* IVectorBatch::createBatch(size_t dim, size_t count, double const* const& rows)
+{
+    if (rows == nullptr)
+    {
+        VectorBatchImpl::log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    IVectorBatch* batch = createBatch(dim, count);
+    if (batch == nullptr)
+        return nullptr;
+
+    // Transposes rows into columns
+    for (size_t axis = 0; axis < dim; ++axis)
+    {
+        double* col = const_cast<double*>(batch->getColumn(axis));
+        for (size_t idx = 0; idx < count; ++idx)
+            col[idx] = rows[idx * dim + axis];
+    }
+
+    return batch;
+}
+
+IVectorBatch::~IVectorBatch() = default;
+
+///////////////////VectorBatchImpl/////////////////
+
+RC VectorBatchImpl::setLogger(ILogger* const pLogger)
+{
+    if (pLogger == nullptr)
+        return RC::NULLPTR_ERROR;
+
+    logger = pLogger;
+    return RC::SUCCESS;
+}
+
+ILogger* VectorBatchImpl::getLogger()
+{
+    return logger;
+}
+
+void VectorBatchImpl::log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line)
+{
+    if (logger != nullptr)
+        logger->log(code, level, srcfile, function, line);
+}
+
+VectorBatchImpl* VectorBatchImpl::allocate(size_t dim, size_t count)
+{
+    const size_t perLine = alignment / sizeof(double);
+    const size_t stride = (count + perLine - 1) / perLine * perLine;
+
+    if (stride != 0 && dim > SIZE_MAX / sizeof(double) / stride)
+        return nullptr;
+
+    double* data = nullptr;
+    if (stride != 0)
+    {
+        data = static_cast<double*>(::operator new(dim * stride * sizeof(double), std::align_val_t(alignment), std::nothrow));
+        if (data == nullptr)
+            return nullptr;
+
+        // Padding is zeroed as well, so whole columns can be processed by kernels
+        memset(data, 0, dim * stride * sizeof(double));
+    }
+
+    VectorBatchImpl* batch = new (std::nothrow) VectorBatchImpl(dim, count, stride, data);
+    if (batch == nullptr)
+        ::operator delete(data, std::align_val_t(alignment));
+
+    return batch;
+}
+
+VectorBatchImpl::VectorBatchImpl(size_t dim, size_t count, size_t stride, double* data) :
+    dim(dim), count(count), stride(stride), data(data)
+{
+}
+
+VectorBatchImpl::~VectorBatchImpl()
+{
+    ::operator delete(data, std::align_val_t(alignment));
+}
+
+IVectorBatch* VectorBatchImpl::clone() const
+{
+    VectorBatchImpl* copy = allocate(dim, count);
+    if (copy == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    if (data != nullptr)
+        memcpy(copy->data, data, dim * stride * sizeof(double));
+
+    return copy;
+}
+
+size_t VectorBatchImpl::getDim() const
+{
+    return dim;
+}
+
+size_t VectorBatchImpl::getSize() const
+{
+    return count;
+}
+
+double* VectorBatchImpl::column(size_t axis) const
+{
+    return data + axis * stride;
+}
+
+double const* VectorBatchImpl::getColumn(size_t axis) const
+{
+    if (axis >= dim)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    return column(axis);
+}
+
+RC VectorBatchImpl::getCoords(size_t index, IVector* const& val) const
+{
+    if (val == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    if (index >= count)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    double* buffer = new (std::nothrow) double[dim];
+    if (buffer == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+
+    for (size_t axis = 0; axis < dim; ++axis)
+        buffer[axis] = column(axis)[index];
+
+    RC err = val->setData(dim, buffer);
+    delete[] buffer;
+
+    return err;
+}
+
+RC VectorBatchImpl::setCoords(size_t index, IVector const* const& val)
+{
+    if (val == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    if (val->getDim() != dim)
+    {
+        log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+
+    if (index >= count)
+    {
+        log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    double const* coords = val->getData();
+    for (size_t axis = 0; axis < dim; ++axis)
+        column(axis)[index] = coords[axis];
+
+    return RC::SUCCESS;
+}
+
+RC VectorBatchImpl::checkQuery(IVector const* query, double* result) const
+{
+    RC err = RC::SUCCESS;
+
+    if (query == nullptr || result == nullptr)
+        err = RC::NULLPTR_ERROR;
+    else if (query->getDim() != dim)
+        err = RC::MISMATCHING_DIMENSIONS;
+
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+void VectorBatchImpl::distancesFrom(double const* point, size_t from, IVector::NORM n, double* result) const
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    const size_t len = count - from;
+
+    auto kernel = kernels.columnSumSquaresDiff;
+    if (n == IVector::NORM::FIRST)
+        kernel = kernels.columnSumAbsDiff;
+    else if (n == IVector::NORM::CHEBYSHEV)
+        kernel = kernels.columnMaxAbsDiff;
+
+    memset(result, 0, len * sizeof(double));
+    for (size_t axis = 0; axis < dim; ++axis)
+        kernel(result, column(axis) + from, point[axis], len);
+
+    if (n == IVector::NORM::SECOND)
+    {
+        for (size_t idx = 0; idx < len; ++idx)
+            result[idx] = sqrt(result[idx]);
+    }
+}
+
+RC VectorBatchImpl::norms(IVector::NORM n, double* result) const
+{
+    if (result == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    if (n == IVector::NORM::AMOUNT)
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    double* origin = new (std::nothrow) double[dim]();
+    if (origin == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+
+    distancesFrom(origin, 0, n, result);
+    delete[] origin;
+
+    return RC::SUCCESS;
+}
+
+RC VectorBatchImpl::dots(IVector const* const& query, double* result) const
+{
+    RC err = checkQuery(query, result);
+    if (err != RC::SUCCESS)
+        return err;
+
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    double const* coords = query->getData();
+
+    memset(result, 0, count * sizeof(double));
+    for (size_t axis = 0; axis < dim; ++axis)
+        kernels.columnAxpy(result, column(axis), coords[axis], count);
+
+    return RC::SUCCESS;
+}
+
+RC VectorBatchImpl::distances(IVector const* const& query, IVector::NORM n, double* result) const
+{
+    RC err = checkQuery(query, result);
+    if (err != RC::SUCCESS)
+        return err;
+
+    if (n == IVector::NORM::AMOUNT)
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    distancesFrom(query->getData(), 0, n, result);
+    return RC::SUCCESS;
+}
+
+RC VectorBatchImpl::axpy(double multiplier, IVector const* const& op)
+{
+    if (op == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    if (op->getDim() != dim)
+    {
+        log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::MISMATCHING_DIMENSIONS;
+    }
+
+    double* shifts = new (std::nothrow) double[dim];
+    if (shifts == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+
+    // Every column gets the same shift, adding an infinite one raises no flags for deferred policies
+    double const* coords = op->getData();
+    RC err = RC::SUCCESS;
+    for (size_t axis = 0; axis < dim && err == RC::SUCCESS; ++axis)
+    {
+        shifts[axis] = multiplier * coords[axis];
+        if (!std::isfinite(shifts[axis]))
+            err = RC::INFINITY_OVERFLOW;
+    }
+
+    // Padding of the columns is left zero
+    if (err == RC::SUCCESS)
+        err = VectorOps::shiftColumns(data, stride, shifts, dim, count);
+
+    delete[] shifts;
+    if (err != RC::SUCCESS)
+        log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+RC VectorBatchImpl::pairwiseDistances(IVector::NORM n, double* result) const
+{
+    if (result == nullptr)
+    {
+        log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    if (n == IVector::NORM::AMOUNT)
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    double* point = new (std::nothrow) double[dim];
+    if (point == nullptr)
+    {
+        log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+
+    // Upper triangle of every row is computed against the following vectors and mirrored below the diagonal
+    for (size_t row = 0; row < count; ++row)
+    {
+        for (size_t axis = 0; axis < dim; ++axis)
+            point[axis] = column(axis)[row];
+
+        double* upper = result + row * count + row + 1;
+        distancesFrom(point, row + 1, n, upper);
+
+        result[row * count + row] = 0;
+        for (size_t other = row + 1; other < count; ++other)
+            result[other * count + row] = upper[other - row - 1];
+    }
+
+    delete[] point;
+    return RC::SUCCESS;
+}
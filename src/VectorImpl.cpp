@@ -1,8 +1,18 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
 #include <cstring>
 #include <math.h>
 #include <limits>
 #include <functional>
+#include "../include/FixedVector.h"
+#include "../include/IVectorView.h"
+#include "../include/ISparseVector.h"
 #include "../myHeaders/VectorImpl.h"
+#include "../myHeaders/VectorKernels.h"
+#include "../myHeaders/VectorOps.h"
+#include "../myHeaders/VectorPool.h"
+#include "../myHeaders/ThreadPool.h"
 #include "../myHeaders/LoggerImpl.h"
 
 
@@ -15,6 +25,74 @@
 
 IVector::~IVector()= default;
 
+namespace
+{
+    template <size_t N>
+    IVector* allocateFixed(double*& data)
+    {
+        auto* vec = new (std::nothrow) FixedVector<N>();
+        data = vec != nullptr ? vec->getMutableData() : nullptr;
+        return vec;
+    }
+
+    /*
+    * New vector of the dimension, data is set to its coordinates. Dimensions having FixedVector get it
+    */
+    IVector* allocateVector(size_t dim, double*& data)
+    {
+        switch (dim)
+        {
+            case 2:
+                return allocateFixed<2>(data);
+            case 3:
+                return allocateFixed<3>(data);
+            case 4:
+                return allocateFixed<4>(data);
+            case 8:
+                return allocateFixed<8>(data);
+            default:
+            {
+                VectorImpl* vec = VectorImpl::allocate(dim);
+                data = vec != nullptr ? vec->data() : nullptr;
+                return vec;
+            }
+        }
+    }
+
+    template <size_t N>
+    double* fixedDataOf(IVector* vec)
+    {
+        auto* fixed = dynamic_cast<FixedVector<N>*>(vec);
+        return fixed != nullptr ? fixed->getMutableData() : nullptr;
+    }
+
+    /*
+    * Coordinates of vec if the implementation lets them be written in place, nullptr otherwise
+    */
+    double* mutableDataOf(IVector* vec)
+    {
+        if (auto* impl = dynamic_cast<VectorImpl*>(vec))
+            return impl->data();
+
+        if (auto* view = dynamic_cast<IMutableVectorView*>(vec))
+            return view->getMutableData();
+
+        switch (vec->getDim())
+        {
+            case 2:
+                return fixedDataOf<2>(vec);
+            case 3:
+                return fixedDataOf<3>(vec);
+            case 4:
+                return fixedDataOf<4>(vec);
+            case 8:
+                return fixedDataOf<8>(vec);
+            default:
+                return nullptr;
+        }
+    }
+}
+
 IVector* IVector::createVector(size_t dim, double const* const& ptr_data)
 {
     if (!ptr_data)
@@ -23,8 +101,8 @@ IVector* IVector::createVector(size_t dim, double const* const& ptr_data)
         return nullptr;
     }
 
-    const size_t _size = sizeof(VectorImpl) + dim * sizeof(double);
-    uint8_t* pInstance = new (std::nothrow)uint8_t[_size];
+    double* data = nullptr;
+    IVector* pInstance = allocateVector(dim, data);
 
     if (!pInstance)
     {
@@ -32,11 +110,9 @@ IVector* IVector::createVector(size_t dim, double const* const& ptr_data)
         return nullptr;
     }
 
-    uint8_t* pData = pInstance + sizeof(VectorImpl);
-
-    memcpy(pData, (uint8_t*)ptr_data, dim * sizeof(double));
+    memcpy(data, ptr_data, dim * sizeof(double));
 
-    return new(pInstance)VectorImpl(dim);
+    return pInstance;
 }
     RC IVector::copyInstance(IVector* const dest, IVector const* const& src)
     {
@@ -52,22 +128,24 @@ IVector* IVector::createVector(size_t dim, double const* const& ptr_data)
             return RC::UNKNOWN;
         }
 
-        memcpy((void*)dest, (void*)src, src->sizeAllocated());
-
-        return RC::SUCCESS;
+        // Coordinates are copied instead of the whole instance, so dest may be a view
+        return dest->setData(src->getDim(), src->getData());
     }
 
 
     IVector* VectorImpl::clone() const
     {
-        int size = sizeof(VectorImpl) + this->getDim() * sizeof(double);
+        VectorImpl* pVector = allocate(dimension);
 
-        auto* pBlock = new uint8_t[size];
-        auto* pVector = (uint8_t*)this;
+        if (!pVector)
+        {
+            log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return nullptr;
+        }
 
-        memcpy(pBlock, pVector, size);
+        memcpy(pVector->data(), getData(), dimension * sizeof(double));
 
-        return (IVector*) pBlock;
+        return pVector;
     }
 
 IVector* IVector::sub(IVector const* const& op1, IVector const* const& op2)
@@ -84,8 +162,23 @@ IVector* IVector::sub(IVector const* const& op1, IVector const* const& op2)
         return nullptr;
     }
 
-    IVector *newVec = op1->clone();
-    newVec->dec(op2);
+    double* data = nullptr;
+    IVector* newVec = allocateVector(op1->getDim(), data);
+
+    if (!newVec)
+    {
+        VectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    // Result goes to fresh memory, so it can be validated after the single pass
+    if (VectorOps::combineInto(data, op1->getData(), op2->getData(), -1.0, op1->getDim()) != RC::SUCCESS)
+    {
+        VectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        delete newVec;
+        return nullptr;
+    }
+
     return newVec;
 }
 
@@ -94,92 +187,441 @@ IVector* IVector::add(IVector const* const& op1, IVector const* const& op2)
     if (!op1 || !op2 || op1->getDim() != op2->getDim())
         return nullptr;
 
-    const double _dimension = op1->getDim();
-    double result;
-    IVector* newVec = op1->clone();
+    double* data = nullptr;
+    IVector* newVec = allocateVector(op1->getDim(), data);
 
     if (!newVec)
         return nullptr;
 
-    const double* data1 = op1->getData();
-    const double* data2 = op2->getData();
-    auto* ptr = (double*)((uint8_t*)newVec + sizeof(VectorImpl));
+    if (VectorOps::combineInto(data, op1->getData(), op2->getData(), 1.0, op1->getDim()) != RC::SUCCESS)
+    {
+        VectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        delete newVec;
+        return nullptr;
+    }
+
+    return newVec;
+}
+
+namespace
+{
+    /*
+    * Coordinate buffers of linear combination operands, small combinations do not touch the heap
+    */
+    class OperandData
+    {
+    public:
+        OperandData(size_t count) : srcs(count <= inlineCount ? inlineSrcs : new (std::nothrow) const double*[count])
+        {
+        }
+
+        ~OperandData()
+        {
+            if (srcs != inlineSrcs)
+                delete[] srcs;
+        }
+
+        static const size_t inlineCount = 16;
+        const double** const srcs;
+
+    private:
+        const double* inlineSrcs[inlineCount];
+    };
+
+    /*
+    * Checks operands of a linear combination and collects their buffers, returns RC::SUCCESS and sets dim if they match
+    */
+    RC gatherOperands(size_t count, double const* coefs, IVector const* const* ops, OperandData& operands, size_t& dim)
+    {
+        if (count == 0 || coefs == nullptr || ops == nullptr)
+            return count == 0 ? RC::INVALID_ARGUMENT : RC::NULLPTR_ERROR;
+
+        if (operands.srcs == nullptr)
+            return RC::ALLOCATION_ERROR;
+
+        for (size_t t = 0; t < count; ++t)
+        {
+            if (ops[t] == nullptr)
+                return RC::NULLPTR_ERROR;
+
+            if (ops[t]->getDim() != ops[0]->getDim())
+                return RC::MISMATCHING_DIMENSIONS;
+
+            if (!std::isfinite(coefs[t]))
+                return RC::INVALID_ARGUMENT;
+
+            operands.srcs[t] = ops[t]->getData();
+        }
+
+        dim = ops[0]->getDim();
+        return RC::SUCCESS;
+    }
+}
+
+RC IVector::linearCombination(IVector* const dest, size_t count, double const* coefs, IVector const* const* ops)
+{
+    OperandData operands(count);
+    size_t dim = 0;
+    RC err = dest == nullptr ? RC::NULLPTR_ERROR : gatherOperands(count, coefs, ops, operands, dim);
+
+    if (err == RC::SUCCESS && dest->getDim() != dim)
+        err = RC::MISMATCHING_DIMENSIONS;
 
-    for (size_t i = 0; i < _dimension; i++)
+    if (err != RC::SUCCESS)
     {
-        result = data1[i] + data2[i];
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return err;
+    }
 
-        if (fabs(result) == std::numeric_limits<double>::infinity())
+    double* dst = mutableDataOf(dest);
+
+    if (dst != nullptr)
+    {
+        err = VectorOps::linear(dst, coefs, operands.srcs, count, dim);
+    }
+    else
+    {
+        // Foreign implementation, the result goes through a temporary vector and setData
+        VectorImpl* tmp = VectorImpl::allocate(dim);
+        if (tmp == nullptr)
         {
-            VectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-            delete newVec;
-            newVec = nullptr;
-            return newVec;
+            VectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return RC::ALLOCATION_ERROR;
         }
 
-        ptr[i] = result;
+        err = VectorOps::linearInto(tmp->data(), coefs, operands.srcs, count, dim);
+        if (err == RC::SUCCESS)
+            err = dest->setData(dim, tmp->getData());
+
+        delete tmp;
+    }
+
+    if (err != RC::SUCCESS)
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+// Lives here since only this file can write coordinates of dense vectors in place
+RC ISparseVector::axpy(IVector* const dest, double multiplier, ISparseVector const* const& op)
+{
+    RC err = RC::SUCCESS;
+    if (dest == nullptr || op == nullptr)
+        err = RC::NULLPTR_ERROR;
+    else if (!std::isfinite(multiplier))
+        err = RC::INVALID_ARGUMENT;
+    else if (dest->getDim() != op->getDim())
+        err = RC::MISMATCHING_DIMENSIONS;
+
+    if (err != RC::SUCCESS)
+    {
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return err;
+    }
+
+    const size_t dim = dest->getDim();
+    double* dst = mutableDataOf(dest);
+
+    if (dst != nullptr)
+    {
+        err = VectorOps::scatterAxpy(dst, op->getIndices(), op->getValues(), multiplier, op->getNonZeroCount());
+    }
+    else
+    {
+        VectorImpl* tmp = VectorImpl::allocate(dim);
+        if (tmp == nullptr)
+        {
+            VectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return RC::ALLOCATION_ERROR;
+        }
+
+        memcpy(tmp->data(), dest->getData(), dim * sizeof(double));
+        err = VectorOps::scatterAxpy(tmp->data(), op->getIndices(), op->getValues(), multiplier, op->getNonZeroCount());
+        if (err == RC::SUCCESS)
+            err = dest->setData(dim, tmp->getData());
+
+        delete tmp;
+    }
+
+    if (err != RC::SUCCESS)
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+IVector* IVector::createLinearCombination(size_t count, double const* coefs, IVector const* const* ops)
+{
+    OperandData operands(count);
+    size_t dim = 0;
+    RC err = gatherOperands(count, coefs, ops, operands, dim);
+
+    if (err != RC::SUCCESS)
+    {
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    double* data = nullptr;
+    IVector* newVec = allocateVector(dim, data);
+
+    if (!newVec)
+    {
+        VectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return nullptr;
+    }
+
+    if (VectorOps::linearInto(data, coefs, operands.srcs, count, dim) != RC::SUCCESS)
+    {
+        VectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        delete newVec;
+        return nullptr;
     }
 
     return newVec;
 }
 
-double IVector::dot(IVector const* const& op1, IVector const* const& op2)
+void VectorDeleter::operator()(IVector* vector) const
 {
+    delete vector;
+}
 
-    if (!op1 || !op2 || op1->getDim() != op2->getDim())
-        return std::numeric_limits<double>::quiet_NaN();
+VectorPtr IVector::createVectorPtr(size_t dim, double const* const& ptr_data)
+{
+    return VectorPtr(createVector(dim, ptr_data));
+}
+
+VectorPtr IVector::clonePtr() const
+{
+    return VectorPtr(clone());
+}
 
+VectorPtr IVector::addPtr(IVector const* const& op1, IVector const* const& op2)
+{
+    return VectorPtr(add(op1, op2));
+}
 
-    double result = 0;
-    const double dim = op1->getDim();
+VectorPtr IVector::subPtr(IVector const* const& op1, IVector const* const& op2)
+{
+    return VectorPtr(sub(op1, op2));
+}
 
-    double const * data1 = op1->getData();
-    double const * data2 = op2->getData();
+VectorPtr IVector::createLinearCombinationPtr(size_t count, double const* coefs, IVector const* const* ops)
+{
+    return VectorPtr(createLinearCombination(count, coefs, ops));
+}
 
-    for (size_t i = 0; i < dim; i++)
+namespace
+{
+    // Chunk boundaries do not depend on the number of threads, which keeps parallel results reproducible
+    const size_t parallelChunk = 1 << 16;
+    std::atomic<size_t> parallelThreshold{1 << 20};
+
+    /*
+    * Reduction of n coordinates, chunk(from, len) reduces one range with a kernel
+    *
+    * Below the threshold the whole range is one chunk. Above it, chunks are reduced in parallel and their results
+    * are folded from the first to the last one, with max instead of + if takeMax is set
+    */
+    template <typename Chunk>
+    double reduce(size_t n, bool takeMax, const Chunk& chunk)
     {
-        result += data1[i] * data2[i];
+        if (n < parallelThreshold.load(std::memory_order_relaxed))
+            return chunk(0, n);
 
-        if(!std::isfinite(fabs(result)))
+        const size_t count = (n + parallelChunk - 1) / parallelChunk;
+        auto rangeOf = [&](size_t idx, size_t& from, size_t& len)
         {
-            VectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-            return std::numeric_limits<double>::quiet_NaN();
+            from = idx * parallelChunk;
+            len = std::min(parallelChunk, n - from);
+        };
+        auto fold = [takeMax](double acc, double val)
+        {
+            return takeMax ? std::max(acc, val) : acc + val;
+        };
+
+        double* partial = new (std::nothrow) double[count];
+        double result = 0;
+        size_t from = 0, len = 0;
+
+        if (partial == nullptr)
+        {
+            // Same chunks folded in the same order, only without threads
+            for (size_t idx = 0; idx < count; ++idx)
+            {
+                rangeOf(idx, from, len);
+                result = fold(result, chunk(from, len));
+            }
+            return result;
         }
+
+        ThreadPool::run(count, [&](size_t idx)
+        {
+            size_t first = 0, size = 0;
+            rangeOf(idx, first, size);
+            partial[idx] = chunk(first, size);
+        });
+
+        for (size_t idx = 0; idx < count; ++idx)
+            result = fold(result, partial[idx]);
+
+        delete[] partial;
+        return result;
+    }
+}
+
+RC IVector::setParallelThreshold(size_t threshold)
+{
+    parallelThreshold.store(threshold, std::memory_order_relaxed);
+    return RC::SUCCESS;
+}
+
+size_t IVector::getParallelThreshold()
+{
+    return parallelThreshold.load(std::memory_order_relaxed);
+}
+
+RC IVector::setThreadCount(size_t count)
+{
+    ThreadPool::setThreadCount(count);
+    return RC::SUCCESS;
+}
+
+double IVector::dot(IVector const* const& op1, IVector const* const& op2)
+{
+
+    if (!op1 || !op2 || op1->getDim() != op2->getDim())
+        return std::numeric_limits<double>::quiet_NaN();
+
+    // Once a partial sum overflows it stays infinite (or turns into NaN), so checking the total is enough
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    double const* a = op1->getData();
+    double const* b = op2->getData();
+    const double result = reduce(op1->getDim(), false, [&](size_t from, size_t len)
+    {
+        return kernels.dot(a + from, b + from, len);
+    });
+
+    if (!std::isfinite(result))
+    {
+        VectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
     }
 
     return result;
 }
 
-bool IVector::equals(IVector const* const& op1, IVector const* const& op2, NORM n, double tol)
+namespace
 {
-    if (op1 == nullptr || op2 == nullptr)
+    // Coordinates compared between early-exit checks
+    const size_t distanceBlock = 256;
+
+    /*
+    * Norm of a - b accumulated block by block, stops once the partial norm exceeds limit and returns it
+    *
+    * Partial norms never decrease, so exceeding limit early means exceeding it in the end. distance() passes infinite
+    * limit to the same routine, so both methods agree on every pair of vectors
+    */
+    double distanceUpTo(const double* a, const double* b, size_t n, IVector::NORM norm, double limit)
     {
-        VectorImpl::log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-        return false;
+        const VectorKernels::Table& kernels = VectorKernels::get();
+        double acc = 0;
+
+        for (size_t from = 0; from < n; from += distanceBlock)
+        {
+            const size_t len = std::min(distanceBlock, n - from);
+            double partial = 0;
+
+            switch (norm)
+            {
+                case IVector::NORM::FIRST:
+                    acc += kernels.sumAbsDiff(a + from, b + from, len);
+                    partial = acc;
+                    break;
+
+                case IVector::NORM::SECOND:
+                    acc += kernels.sumSquaresDiff(a + from, b + from, len);
+                    partial = sqrt(acc);
+                    break;
+
+                case IVector::NORM::CHEBYSHEV:
+                {
+                    const double val = kernels.maxAbsDiff(a + from, b + from, len);
+                    if (std::isnan(val))
+                        return val;
+                    if (val > acc)
+                        acc = val;
+                    partial = acc;
+                    break;
+                }
+
+                default:
+                    return std::numeric_limits<double>::quiet_NaN();
+            }
+
+            if (partial > limit)
+                return partial;
+        }
+
+        return norm == IVector::NORM::SECOND ? sqrt(acc) : acc;
     }
 
-    if (op1->getDim() != op2->getDim())
+    RC checkDistanceArgs(IVector const* op1, IVector const* op2, IVector::NORM n)
     {
-        VectorImpl::log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-        return false;
+        if (op1 == nullptr || op2 == nullptr)
+            return RC::NULLPTR_ERROR;
+
+        if (op1->getDim() != op2->getDim())
+            return RC::MISMATCHING_DIMENSIONS;
+
+        if (n != IVector::NORM::FIRST && n != IVector::NORM::SECOND && n != IVector::NORM::CHEBYSHEV)
+            return RC::INVALID_ARGUMENT;
+
+        return RC::SUCCESS;
     }
+}
+
+double IVector::distance(IVector const* const& op1, IVector const* const& op2, NORM n)
+{
+    RC err = checkDistanceArgs(op1, op2, n);
 
-    if (tol < 0)
+    if (err != RC::SUCCESS)
     {
-        VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-        return false;
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    const double result =
+        distanceUpTo(op1->getData(), op2->getData(), op1->getDim(), n, std::numeric_limits<double>::infinity());
+
+    if (!std::isfinite(result))
+    {
+        VectorImpl::log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
     }
 
-    IVector *sub = IVector::sub(op1, op2);
+    return result;
+}
+
+bool IVector::withinTolerance(IVector const* const& op1, IVector const* const& op2, NORM n, double tol)
+{
+    RC err = checkDistanceArgs(op1, op2, n);
 
-    if (sub->norm(n) > tol)
+    if (err == RC::SUCCESS && !(tol >= 0))
+        err = RC::INVALID_ARGUMENT;
+
+    if (err != RC::SUCCESS)
     {
-        delete sub;
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
         return false;
     }
 
-    delete sub;
-    return true;
+    // Overflowed or NaN distance is never within tolerance
+    return distanceUpTo(op1->getData(), op2->getData(), op1->getDim(), n, tol) <= tol;
+}
+
+bool IVector::equals(IVector const* const& op1, IVector const* const& op2, NORM n, double tol)
+{
+    return withinTolerance(op1, op2, n, tol);
 }
 
 RC IVector::moveInstance(IVector* const dest, IVector*& src)
@@ -189,25 +631,143 @@ RC IVector::moveInstance(IVector* const dest, IVector*& src)
         return RC::NULLPTR_ERROR;
     }
 
-    if (dest->sizeAllocated() != src->sizeAllocated() || dest->getDim() != src->getDim())
+    if (dest->getDim() != src->getDim())
     {
         return RC::MISMATCHING_DIMENSIONS;
     }
 
-    const size_t srcSizeAllocated = src->sizeAllocated();
-
-    memmove(reinterpret_cast<uint8_t*>(dest), reinterpret_cast<const uint8_t*>(src), srcSizeAllocated);
+    RC err = dest->setData(src->getDim(), src->getData());
+    if (err != RC::SUCCESS)
+        return err;
 
     delete src;
 
-    src = nullptr;
+    src = nullptr;
+
+    return RC::SUCCESS;
+}
+
+RC IVector::setLogger(ILogger *const logger)
+{
+    return VectorImpl::setLogger(logger);
+}
+
+RC IVector::setOverflowCheck(OVERFLOW_CHECK check)
+{
+    RC err = VectorOps::setOverflowCheck(check);
+
+    if (err != RC::SUCCESS)
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+IVector::OVERFLOW_CHECK IVector::getOverflowCheck()
+{
+    return VectorOps::getOverflowCheck();
+}
+
+RC IVector::checkDeferredOverflow()
+{
+    return VectorOps::checkDeferredOverflow();
+}
+
+RC IVector::applyBatch(const std::function<void(double* values, size_t count)>& fun)
+{
+    // Implementations outside of the library are reachable only through getData and setData
+    const size_t dim = getDim();
+    double* values = new (std::nothrow) double[dim];
+    if (values == nullptr)
+    {
+        VectorImpl::log(RC::ALLOCATION_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::ALLOCATION_ERROR;
+    }
+
+    memcpy(values, getData(), dim * sizeof(double));
+    fun(values, dim);
+
+    RC err = VectorKernels::get().isFinite(values, dim) ? setData(dim, values) : RC::INFINITY_OVERFLOW;
+    delete[] values;
+
+    if (err != RC::SUCCESS)
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+RC IVector::applyFunction(FUNCTION fun)
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    void (*kernel)(double*, const double*, size_t) = nullptr;
+
+    switch (fun)
+    {
+        case FUNCTION::ABS:
+            kernel = kernels.absValues;
+            break;
+
+        case FUNCTION::SQRT:
+            kernel = kernels.sqrtValues;
+            break;
+
+        case FUNCTION::EXP:
+            kernel = kernels.expValues;
+            break;
+
+        case FUNCTION::LOG:
+            kernel = kernels.logValues;
+            break;
+
+        case FUNCTION::SIGMOID:
+            kernel = kernels.sigmoidValues;
+            break;
+
+        default:
+        {
+            VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return RC::INVALID_ARGUMENT;
+        }
+    }
+
+    return applyBatch([kernel](double* values, size_t count) { kernel(values, values, count); });
+}
+
+RC IVector::clamp(double lower, double upper)
+{
+    if (!(lower <= upper))
+    {
+        VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
+    }
+
+    const auto clampValues = VectorKernels::get().clampValues;
+    return applyBatch([=](double* values, size_t count) { clampValues(values, values, lower, upper, count); });
+}
+
+RC IVector::getPoolStats(PoolStats& stats)
+{
+    VectorPool::getStats(stats);
+    return RC::SUCCESS;
+}
 
+RC IVector::releasePool()
+{
+    VectorPool::release();
     return RC::SUCCESS;
 }
 
-RC IVector::setLogger(ILogger *const logger)
+IVector::Arena::Arena(size_t regionSize) : state(VectorPool::pushArena(regionSize))
 {
-    return VectorImpl::setLogger(logger);
+}
+
+IVector::Arena::~Arena()
+{
+    VectorPool::popArena(state);
+}
+
+size_t IVector::Arena::bytesUsed() const
+{
+    return VectorPool::arenaBytesUsed(state);
 }
 
 ///////////////////VectorImpl////////////////
@@ -215,11 +775,26 @@ RC IVector::setLogger(ILogger *const logger)
 
     VectorImpl::~VectorImpl() = default;
 
+    void VectorImpl::operator delete(void* ptr)
+    {
+        VectorPool::deallocate(ptr);
+    }
+
 
 
+    size_t VectorImpl::dataOffset()
+    {
+        return (sizeof(VectorImpl) + VectorPool::alignment - 1) / VectorPool::alignment * VectorPool::alignment;
+    }
+
+    size_t VectorImpl::paddedDim(size_t dim)
+    {
+        return (dim + simdWidth - 1) / simdWidth * simdWidth;
+    }
+
     size_t  VectorImpl::sizeAllocated() const
     {
-        return dimension*sizeof(double) + sizeof(VectorImpl);
+        return dataOffset() + paddedDim(dimension) * sizeof(double);
     }
 
     RC VectorImpl::setLogger(ILogger *const logger)
@@ -228,6 +803,23 @@ RC IVector::setLogger(ILogger *const logger)
         return RC::SUCCESS;
     }
 
+    VectorImpl* VectorImpl::allocate(size_t dim)
+    {
+        if (dim > (SIZE_MAX - dataOffset()) / sizeof(double) - simdWidth)
+            return nullptr;
+
+        const size_t _size = dataOffset() + paddedDim(dim) * sizeof(double);
+        void* pInstance = VectorPool::allocate(_size);
+
+        if (!pInstance)
+            return nullptr;
+
+        VectorImpl* vec = new(pInstance)VectorImpl(dim);
+        // Padding stays zero for the whole life of the vector, so it does not change results of elementwise kernels
+        memset(vec->data() + dim, 0, (paddedDim(dim) - dim) * sizeof(double));
+        return vec;
+    }
+
     void VectorImpl::log(RC code, ILogger::Level level, const char* const& srcfile, const char* const& function, int line)
     {
         if (pLogger != nullptr)
@@ -237,6 +829,11 @@ RC IVector::setLogger(ILogger *const logger)
 
 
     RC VectorImpl::scale(double multiplier)
+    {
+        return scaleOf(data(), paddedDim(dimension), multiplier);
+    }
+
+    RC VectorImpl::scaleOf(double* data, size_t dim, double multiplier)
     {
         if (multiplier == 1.0)
             return RC::SUCCESS;
@@ -247,107 +844,73 @@ RC IVector::setLogger(ILogger *const logger)
             return RC::INVALID_ARGUMENT;
         }
 
+        RC err = VectorOps::scale(data, multiplier, dim);
 
-        double* ptr = (double*)((uint8_t*)this + sizeof(VectorImpl));
-
-        for (size_t i = 0; i < dimension; i++)
+        if (err == RC::INFINITY_OVERFLOW)
         {
-            if (!std::isfinite(fabs(ptr[i] * multiplier)));
-            {
-                log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-                return RC::INVALID_ARGUMENT;
-            }
+            log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+            return RC::INVALID_ARGUMENT;
         }
 
-
-        for (size_t i = 0; i < dimension; i++)
-        {
-            ptr[i] *= multiplier;
-        }
-        return RC::SUCCESS;
+        return err;
     }
 
     RC VectorImpl::inc(IVector const* const& op)
     {
-        if (!op)
-            return RC::INVALID_ARGUMENT;
-
-        if (dimension != op->getDim())
-        {
-            log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-            return RC::MISMATCHING_DIMENSIONS;
-        }
-
-        const double* ptr2 = op->getData();
-        double* ptr1 = (double*)((uint8_t*)this + sizeof(VectorImpl));
+        return combineOf(data(), dimension, op, 1.0, lengthWith(op));
+    }
 
-        for (size_t i = 0; i < dimension; i++)
-        {
-            if (!std::isfinite(fabs(ptr1[i] + ptr2[i])))
-            {
-                log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-                return RC::INFINITY_OVERFLOW;
-            }
-        }
+    RC VectorImpl::dec(IVector const* const& op)
+    {
+        return combineOf(data(), dimension, op, -1.0, lengthWith(op));
+    }
 
-        for (size_t i = 0; i < dimension; i++)
-        {
-            ptr1[i] += ptr2[i];
-        }
+    size_t VectorImpl::lengthWith(IVector const* op) const
+    {
+        if (dynamic_cast<VectorImpl const*>(op) != nullptr)
+            return paddedDim(dimension);
 
-        return RC::SUCCESS;
+        return dimension;
     }
 
-    RC VectorImpl::dec(IVector const* const& op)
+    RC VectorImpl::combineOf(double* data, size_t dim, IVector const* op, double sign, size_t len)
     {
         if (!op)
             return RC::INVALID_ARGUMENT;
 
-        if (dimension != op->getDim())
+        if (dim != op->getDim())
         {
             log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
             return RC::MISMATCHING_DIMENSIONS;
         }
 
-        const double* ptr2 = op->getData();
-        double* ptr1 = (double*)((uint8_t*)this + sizeof(VectorImpl));
-
-        for (size_t i = 0; i < dimension; i++)
-        {
-            if (!std::isfinite(fabs(ptr1[i] - ptr2[i])))
-            {
-                log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-                return RC::INFINITY_OVERFLOW;
-            }
-        }
+        RC err = VectorOps::combine(data, op->getData(), sign, len);
 
-        for (size_t i = 0; i < dimension; i++)
-        {
-            ptr1[i] -= ptr2[i];
-        }
+        if (err != RC::SUCCESS)
+            log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
 
-        return RC::SUCCESS;
+        return err;
     }
 
     RC VectorImpl::applyFunction(const std::function<double(double)>& fun)
     {
-        double* data = (double*)(reinterpret_cast<const uint8_t*>(this) + sizeof(VectorImpl));
+        RC err = VectorOps::apply(data(), dimension, fun);
 
-        for (int i = 0; i < dimension; i++)
-        {
-            if (!std::isfinite(fabs(fun(data[i]))))
-            {
-                log(RC::INFINITY_OVERFLOW, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-                return RC::INFINITY_OVERFLOW;
-            }
-        }
+        if (err != RC::SUCCESS)
+            log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
 
-        for (int i = 0; i < dimension; i++)
-        {
-            data[i] = fun(data[i]);
-        }
+        return err;
+    }
 
-        return RC::SUCCESS;
+    RC VectorImpl::applyBatch(const std::function<void(double* values, size_t count)>& fun)
+    {
+        // Padding is left out, it has to stay zero
+        RC err = VectorOps::applyBatch(data(), dimension, fun);
+
+        if (err != RC::SUCCESS)
+            log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+        return err;
     }
 
 
@@ -357,7 +920,12 @@ RC IVector::setLogger(ILogger *const logger)
 
     double const *VectorImpl::getData() const
     {
-        return (double *)((uint8_t *)(this) + sizeof(VectorImpl));
+        return (double *)((uint8_t *)(this) + dataOffset());
+    }
+
+    double* VectorImpl::data()
+    {
+        return (double *)((uint8_t *)(this) + dataOffset());
     }
 
     size_t VectorImpl::getDim() const
@@ -379,60 +947,35 @@ RC IVector::setLogger(ILogger *const logger)
             return RC::INVALID_ARGUMENT;
         }
 
-        auto* ptr = (double*)((uint8_t*)this + sizeof(VectorImpl) + index * sizeof(double));
+        auto* ptr = (double*)((uint8_t*)this + dataOffset() + index * sizeof(double));
         val = *ptr;
         return RC::SUCCESS;
     }
 
 double VectorImpl::norm(NORM n) const
+{
+    return normOf(getData(), dimension, n);
+}
+
+double VectorImpl::normOf(double const* data, size_t dim, NORM n)
 {
     double result = 0;
-    const double* data = this->getData();
+    const VectorKernels::Table& kernels = VectorKernels::get();
 
     switch (n)
     {
         case NORM::FIRST:
-            for (size_t i = 0; i < this->getDim(); i++)
-            {
-                result += fabs(data[i]);
-
-                if (!std::isfinite(fabs(result)))
-                {
-                    log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-                    return std::numeric_limits<double>::quiet_NaN();;
-                }
-            }
-
+            result = reduce(dim, false, [&](size_t from, size_t len) { return kernels.sumAbs(data + from, len); });
             break;
 
         case NORM::SECOND:
-            for (size_t i = 0; i < this->getDim(); i++)
-            {
-                result += data[i] * data[i];
-
-                if (!std::isfinite(fabs(result)))
-                {
-                    log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-                    return std::numeric_limits<double>::quiet_NaN();;
-                }
-            }
-            result = sqrt(result);
+            result = sqrt(reduce(dim, false, [&](size_t from, size_t len) { return kernels.sumSquares(data + from, len); }));
             break;
 
         case NORM::CHEBYSHEV:
-            result = 0;
-            for (size_t i = 0; i < this->getDim(); i++)
-            {
-                if (fabs(data[i]) > result)
-                    result = fabs(data[i]);
-
-                if (!std::isfinite(fabs(result)))
-                {
-                    log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
-                    return std::numeric_limits<double>::quiet_NaN();
-                }
-            }
+            result = reduce(dim, true, [&](size_t from, size_t len) { return kernels.maxAbs(data + from, len); });
             break;
+
         default:
         {
             log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
@@ -440,12 +983,19 @@ double VectorImpl::norm(NORM n) const
         }
     }
 
+    // Every accumulated term is non-negative, so an overflow anywhere shows up in the result
+    if (!std::isfinite(result))
+    {
+        log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
     return result;
 }
 
 RC VectorImpl::foreach(const std::function<void(double)>& fun) const
 {
-    double* data = (double*)((uint8_t*)this + sizeof(VectorImpl));
+    double* data = (double*)((uint8_t*)this + dataOffset());
 
     for (size_t i = 0; i < dimension; i++)
     {
@@ -468,7 +1018,7 @@ RC VectorImpl::setCord(size_t index, double val)
         log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
         return RC::INVALID_ARGUMENT;
     }
-    auto* ptr = (double*)((uint8_t*)this + sizeof(VectorImpl) + index * sizeof(double));
+    auto* ptr = (double*)((uint8_t*)this + dataOffset() + index * sizeof(double));
     *ptr = val;
 
     return RC::SUCCESS;
@@ -476,7 +1026,12 @@ RC VectorImpl::setCord(size_t index, double val)
 
 RC VectorImpl::setData(size_t dim, double const* const& ptr_data)
 {
-    if (this->dimension != dim)
+    return setDataOf(data(), dimension, dim, ptr_data);
+}
+
+RC VectorImpl::setDataOf(double* data, size_t dim, size_t srcDim, double const* ptr_data)
+{
+    if (dim != srcDim)
     {
         VectorImpl::log(RC::MISMATCHING_DIMENSIONS, ILogger::Level::SEVERE, __FILE__, __func__, __LINE__);
         return RC::MISMATCHING_DIMENSIONS;
@@ -495,15 +1050,256 @@ RC VectorImpl::setData(size_t dim, double const* const& ptr_data)
             return RC::NOT_NUMBER;
         }
 
-    for (size_t idx = 0; idx < dim; ++idx)
+    // Source may overlap the destination, e.g. when a view is copied into itself
+    memmove(data, ptr_data, dim * sizeof(double));
+
+    return RC::SUCCESS;
+}
+
+
+///////////////////IVectorView////////////////
+
+
+IVectorView::IVectorView(size_t dim, double const* ptr_data) : data(ptr_data), dim(dim)
+{
+}
+
+RC IVectorView::rebind(double const* ptr_data)
+{
+    if (ptr_data == nullptr)
+    {
+        VectorImpl::log(RC::NULLPTR_ERROR, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::NULLPTR_ERROR;
+    }
+
+    data = ptr_data;
+    return RC::SUCCESS;
+}
+
+IVector* IVectorView::clone() const
+{
+    return IVector::createVector(dim, data);
+}
+
+double const* IVectorView::getData() const
+{
+    return data;
+}
+
+size_t IVectorView::getDim() const
+{
+    return dim;
+}
+
+size_t IVectorView::sizeAllocated() const
+{
+    return sizeof(*this);
+}
+
+RC IVectorView::getCord(size_t index, double& val) const
+{
+    if (index >= dim)
+    {
+        VectorImpl::log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    val = data[index];
+    return RC::SUCCESS;
+}
+
+double IVectorView::norm(NORM n) const
+{
+    return VectorImpl::normOf(data, dim, n);
+}
+
+RC IVectorView::foreach(const std::function<void(double)>& fun) const
+{
+    for (size_t i = 0; i < dim; i++)
+        fun(data[i]);
+
+    return RC::SUCCESS;
+}
+
+RC IVectorView::setData(size_t, double const* const&)
+{
+    VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return RC::INVALID_ARGUMENT;
+}
+
+RC IVectorView::setCord(size_t, double)
+{
+    VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return RC::INVALID_ARGUMENT;
+}
+
+RC IVectorView::scale(double)
+{
+    VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return RC::INVALID_ARGUMENT;
+}
+
+RC IVectorView::inc(IVector const* const&)
+{
+    VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return RC::INVALID_ARGUMENT;
+}
+
+RC IVectorView::dec(IVector const* const&)
+{
+    VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return RC::INVALID_ARGUMENT;
+}
+
+RC IVectorView::applyFunction(const std::function<double(double)>&)
+{
+    VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return RC::INVALID_ARGUMENT;
+}
+
+RC IVectorView::applyBatch(const std::function<void(double* values, size_t count)>&)
+{
+    VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+    return RC::INVALID_ARGUMENT;
+}
+
+IVectorView::~IVectorView() = default;
+
+
+///////////////////IMutableVectorView////////////////
+
+
+IMutableVectorView::IMutableVectorView(size_t dim, double* ptr_data) : IVectorView(dim, ptr_data)
+{
+}
+
+RC IMutableVectorView::rebind(double* ptr_data)
+{
+    return IVectorView::rebind(ptr_data);
+}
+
+// Buffer was given as mutable to the constructor or rebind, so writing through it is legal
+double* IMutableVectorView::getMutableData() const
+{
+    return const_cast<double*>(data);
+}
+
+RC IMutableVectorView::setData(size_t srcDim, double const* const& ptr_data)
+{
+    return VectorImpl::setDataOf(getMutableData(), dim, srcDim, ptr_data);
+}
+
+RC IMutableVectorView::setCord(size_t index, double val)
+{
+    if (index >= dim)
+    {
+        VectorImpl::log(RC::INDEX_OUT_OF_BOUND, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INDEX_OUT_OF_BOUND;
+    }
+
+    if (!std::isfinite(val))
     {
-        *( (double *)((uint8_t *)(this) + sizeof(VectorImpl)) + idx) = ptr_data[idx];
+        VectorImpl::log(RC::INVALID_ARGUMENT, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+        return RC::INVALID_ARGUMENT;
     }
 
+    getMutableData()[index] = val;
     return RC::SUCCESS;
 }
 
+RC IMutableVectorView::scale(double multiplier)
+{
+    return VectorImpl::scaleOf(getMutableData(), dim, multiplier);
+}
+
+RC IMutableVectorView::inc(IVector const* const& op)
+{
+    return VectorImpl::combineOf(getMutableData(), dim, op, 1.0, dim);
+}
+
+RC IMutableVectorView::dec(IVector const* const& op)
+{
+    return VectorImpl::combineOf(getMutableData(), dim, op, -1.0, dim);
+}
+
+RC IMutableVectorView::applyFunction(const std::function<double(double)>& fun)
+{
+    RC err = VectorOps::apply(getMutableData(), dim, fun);
+
+    if (err != RC::SUCCESS)
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+RC IMutableVectorView::applyBatch(const std::function<void(double* values, size_t count)>& fun)
+{
+    RC err = VectorOps::applyBatch(getMutableData(), dim, fun);
+
+    if (err != RC::SUCCESS)
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+IMutableVectorView::~IMutableVectorView() = default;
+
+
+///////////////////FixedVector////////////////
+
+
+void FixedVectorBase::log(RC code, const char* srcfile, const char* function, int line)
+{
+    VectorImpl::log(code, ILogger::Level::SEVERE, srcfile, function, line);
+}
+
+RC FixedVectorBase::setDataOf(double* coords, size_t n, size_t dim, double const* ptr_data)
+{
+    return VectorImpl::setDataOf(coords, n, dim, ptr_data);
+}
+
+RC FixedVectorBase::scaleOf(double* coords, size_t n, double multiplier)
+{
+    return VectorImpl::scaleOf(coords, n, multiplier);
+}
+
+RC FixedVectorBase::combineOf(double* coords, size_t n, IVector const* op, double sign)
+{
+    return VectorImpl::combineOf(coords, n, op, sign, n);
+}
+
+RC FixedVectorBase::applyOf(double* coords, size_t n, const std::function<double(double)>& fun)
+{
+    RC err = VectorOps::apply(coords, n, fun);
+
+    if (err != RC::SUCCESS)
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
+
+    return err;
+}
+
+RC FixedVectorBase::applyBatchOf(double* coords, size_t n, const std::function<void(double* values, size_t count)>& fun)
+{
+    RC err = VectorOps::applyBatch(coords, n, fun);
+
+    if (err != RC::SUCCESS)
+        VectorImpl::log(err, ILogger::Level::SEVERE, __FILE__, __FUNCTION__, __LINE__);
 
+    return err;
+}
 
+void* FixedVectorBase::allocate(size_t size)
+{
+    return VectorPool::allocate(size);
+}
 
+void FixedVectorBase::deallocate(void* ptr)
+{
+    VectorPool::deallocate(ptr);
+}
 
+// Instances the library itself creates
+template class FixedVector<2>;
+template class FixedVector<3>;
+template class FixedVector<4>;
+template class FixedVector<8>;
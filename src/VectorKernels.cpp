@@ -0,0 +1,2512 @@
+#include <cfloat>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include "../myHeaders/VectorKernels.h"
+
+// Kernels must give the same bits on every instruction set, so the compiler may not fuse a multiply and an add
+// into an FMA, which AVX-512 targets allow
+#if defined(__clang__)
+#pragma STDC FP_CONTRACT OFF
+#elif defined(__GNUC__)
+#pragma GCC optimize("fp-contract=off")
+#endif
+
+#ifdef VECTOR_KERNELS_X86
+#include <immintrin.h>
+#define KERNEL_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace
+{
+    ///////////////////Scalar/////////////////
+
+    void combineScalar(double* dst, const double* a, const double* b, double sign, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = a[i] + sign * b[i];
+    }
+
+    bool combineIsFiniteScalar(const double* a, const double* b, double sign, size_t n)
+    {
+        // r - r is zero for every finite r and NaN for infinities and NaNs
+        double acc = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double r = a[i] + sign * b[i];
+            acc += r - r;
+        }
+        return acc == 0;
+    }
+
+    bool combineCheckedScalar(double* dst, const double* a, const double* b, double sign, size_t n)
+    {
+        double acc = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double r = a[i] + sign * b[i];
+            dst[i] = r;
+            acc += r - r;
+        }
+        return acc == 0;
+    }
+
+    // Terms are always accumulated in the same order without FMA, so every instruction set gives the same bits
+
+    void linearRange(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t from, size_t n)
+    {
+        for (size_t i = from; i < n; ++i)
+        {
+            double acc = 0;
+            for (size_t t = 0; t < count; ++t)
+                acc += coefs[t] * srcs[t][i];
+            dst[i] = acc;
+        }
+    }
+
+    bool linearIsFiniteRange(const double* coefs, const double* const* srcs, size_t count, size_t from, size_t n)
+    {
+        double bad = 0;
+        for (size_t i = from; i < n; ++i)
+        {
+            double acc = 0;
+            for (size_t t = 0; t < count; ++t)
+                acc += coefs[t] * srcs[t][i];
+            bad += acc - acc;
+        }
+        return bad == 0;
+    }
+
+    bool linearCheckedRange(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t from, size_t n)
+    {
+        double bad = 0;
+        for (size_t i = from; i < n; ++i)
+        {
+            double acc = 0;
+            for (size_t t = 0; t < count; ++t)
+                acc += coefs[t] * srcs[t][i];
+            dst[i] = acc;
+            bad += acc - acc;
+        }
+        return bad == 0;
+    }
+
+    void linearScalar(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        linearRange(dst, coefs, srcs, count, 0, n);
+    }
+
+    bool linearIsFiniteScalar(const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        return linearIsFiniteRange(coefs, srcs, count, 0, n);
+    }
+
+    bool linearCheckedScalar(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        return linearCheckedRange(dst, coefs, srcs, count, 0, n);
+    }
+
+    void scaleScalar(double* dst, const double* a, double multiplier, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = a[i] * multiplier;
+    }
+
+    bool scaleIsFiniteScalar(const double* a, double multiplier, size_t n)
+    {
+        double acc = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double r = a[i] * multiplier;
+            acc += r - r;
+        }
+        return acc == 0;
+    }
+
+    void shiftScalar(double* dst, const double* a, double c, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = a[i] + c;
+    }
+
+    bool shiftIsFiniteScalar(const double* a, double c, size_t n)
+    {
+        double acc = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double r = a[i] + c;
+            acc += r - r;
+        }
+        return acc == 0;
+    }
+
+    bool isFiniteScalar(const double* a, size_t n)
+    {
+        double acc = 0;
+        for (size_t i = 0; i < n; ++i)
+            acc += a[i] - a[i];
+        return acc == 0;
+    }
+
+    double dotScalar(const double* a, const double* b, size_t n)
+    {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        for (; i < n; ++i)
+            s0 += a[i] * b[i];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    double sumAbsScalar(const double* a, size_t n)
+    {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 += std::fabs(a[i]);
+            s1 += std::fabs(a[i + 1]);
+            s2 += std::fabs(a[i + 2]);
+            s3 += std::fabs(a[i + 3]);
+        }
+        for (; i < n; ++i)
+            s0 += std::fabs(a[i]);
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    double sumSquaresScalar(const double* a, size_t n)
+    {
+        return dotScalar(a, a, n);
+    }
+
+    double maxAbsScalar(const double* a, size_t n)
+    {
+        double result = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double val = std::fabs(a[i]);
+            if (val > result)
+                result = val;
+        }
+        return result;
+    }
+
+    double sumAbsDiffScalar(const double* a, const double* b, size_t n)
+    {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 += std::fabs(a[i] - b[i]);
+            s1 += std::fabs(a[i + 1] - b[i + 1]);
+            s2 += std::fabs(a[i + 2] - b[i + 2]);
+            s3 += std::fabs(a[i + 3] - b[i + 3]);
+        }
+        for (; i < n; ++i)
+            s0 += std::fabs(a[i] - b[i]);
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    double sumSquaresDiffScalar(const double* a, const double* b, size_t n)
+    {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const double d0 = a[i] - b[i], d1 = a[i + 1] - b[i + 1], d2 = a[i + 2] - b[i + 2], d3 = a[i + 3] - b[i + 3];
+            s0 += d0 * d0;
+            s1 += d1 * d1;
+            s2 += d2 * d2;
+            s3 += d3 * d3;
+        }
+        for (; i < n; ++i)
+            s0 += (a[i] - b[i]) * (a[i] - b[i]);
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    // NaN difference is returned as is, so it is not mistaken for a small distance
+    double maxAbsDiffScalar(const double* a, const double* b, size_t n)
+    {
+        double result = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double val = std::fabs(a[i] - b[i]);
+            if (val > result)
+                result = val;
+            else if (std::isnan(val))
+                return val;
+        }
+        return result;
+    }
+
+
+    ///////////////////Scalar column kernels/////////////////
+
+    void columnSumAbsDiffScalar(double* acc, const double* col, double c, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            acc[i] += std::fabs(col[i] - c);
+    }
+
+    void columnSumSquaresDiffScalar(double* acc, const double* col, double c, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            acc[i] += (col[i] - c) * (col[i] - c);
+    }
+
+    void columnMaxAbsDiffScalar(double* acc, const double* col, double c, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            // NaN of the column wins, as in maxAbsDiff
+            const double val = std::fabs(col[i] - c);
+            if (!(val <= acc[i]))
+                acc[i] = val;
+        }
+    }
+
+    void columnAxpyScalar(double* acc, const double* col, double c, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            acc[i] += c * col[i];
+    }
+
+    ///////////////////Scalar single precision kernels/////////////////
+
+    // Coordinates are widened to double before any arithmetic, so float storage costs no accuracy of the results
+
+    double dotFloatScalar(const float* a, const float* b, size_t n)
+    {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 += (double)a[i] * b[i];
+            s1 += (double)a[i + 1] * b[i + 1];
+            s2 += (double)a[i + 2] * b[i + 2];
+            s3 += (double)a[i + 3] * b[i + 3];
+        }
+        for (; i < n; ++i)
+            s0 += (double)a[i] * b[i];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    double dotMixedScalar(const float* a, const double* b, size_t n)
+    {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 += a[i] * b[i];
+            s1 += a[i + 1] * b[i + 1];
+            s2 += a[i + 2] * b[i + 2];
+            s3 += a[i + 3] * b[i + 3];
+        }
+        for (; i < n; ++i)
+            s0 += a[i] * b[i];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    double sumAbsFloatScalar(const float* a, size_t n)
+    {
+        double s0 = 0, s1 = 0;
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            s0 += std::fabs((double)a[i]);
+            s1 += std::fabs((double)a[i + 1]);
+        }
+        for (; i < n; ++i)
+            s0 += std::fabs((double)a[i]);
+        return s0 + s1;
+    }
+
+    double sumSquaresFloatScalar(const float* a, size_t n)
+    {
+        return dotFloatScalar(a, a, n);
+    }
+
+    double maxAbsFloatScalar(const float* a, size_t n)
+    {
+        double result = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double val = std::fabs((double)a[i]);
+            if (val > result)
+                result = val;
+        }
+        return result;
+    }
+
+    double sumAbsDiffFloatScalar(const float* a, const float* b, size_t n)
+    {
+        double s0 = 0, s1 = 0;
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            s0 += std::fabs((double)a[i] - b[i]);
+            s1 += std::fabs((double)a[i + 1] - b[i + 1]);
+        }
+        for (; i < n; ++i)
+            s0 += std::fabs((double)a[i] - b[i]);
+        return s0 + s1;
+    }
+
+    double sumSquaresDiffFloatScalar(const float* a, const float* b, size_t n)
+    {
+        double s0 = 0, s1 = 0;
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const double d0 = (double)a[i] - b[i], d1 = (double)a[i + 1] - b[i + 1];
+            s0 += d0 * d0;
+            s1 += d1 * d1;
+        }
+        for (; i < n; ++i)
+            s0 += ((double)a[i] - b[i]) * ((double)a[i] - b[i]);
+        return s0 + s1;
+    }
+
+    double maxAbsDiffFloatScalar(const float* a, const float* b, size_t n)
+    {
+        double result = 0;
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double val = std::fabs((double)a[i] - b[i]);
+            if (val > result)
+                result = val;
+            else if (std::isnan(val))
+                return val;
+        }
+        return result;
+    }
+
+    ///////////////////Scalar elementwise functions/////////////////
+
+    // exp and log are evaluated by the same polynomials with the same operations in every variant, std::exp and
+    // std::log would give the tails of vectorized loops different roundings than their bodies
+
+    const double log2e = 1.4426950408889634;
+    const double ln2Hi = 6.93147180369123816490e-01; // upper bits of ln 2, k * ln2Hi is exact for |k| < 2^11
+    const double ln2Lo = 1.90821492927058770002e-10;
+    const double sqrt2 = 1.4142135623730951;
+    // x + roundMagic - roundMagic rounds x to an integer, which is then stored in the low bits of the sum
+    const double roundMagic = 6755399441055744.0; // 1.5 * 2^52
+    const double exponentMagic = roundMagic + 1023;
+    const double exponentBias = 4503599627370496.0 + 1023; // 2^52 + 1023
+    const double subnormalScale = 4503599627370496.0;      // 2^52
+    // Beyond these bounds exp is infinity or zero anyway, clamping keeps the scale factors in range
+    const double expMin = -746;
+    const double expMax = 710;
+
+    const uint64_t mantissaMask = 0x000FFFFFFFFFFFFFull;
+    const uint64_t oneBits = 0x3FF0000000000000ull;
+    const uint64_t twoPow52Bits = 0x4330000000000000ull;
+
+    // 1/13!, ..., 1/1!, 1/0!, Taylor series of exp(r) for |r| <= ln(2) / 2
+    const double expCoefs[] = {
+        1.0 / 6227020800.0, 1.0 / 479001600.0, 1.0 / 39916800.0, 1.0 / 3628800.0, 1.0 / 362880.0,
+        1.0 / 40320.0, 1.0 / 5040.0, 1.0 / 720.0, 1.0 / 120.0, 1.0 / 24.0, 1.0 / 6.0, 1.0 / 2.0, 1.0, 1.0
+    };
+    const size_t expTerms = sizeof(expCoefs) / sizeof(expCoefs[0]);
+
+    // 2/23, ..., 2/5, 2/3, series of log(m) = 2s + s * z * P(z), where s = (m - 1) / (m + 1), z = s^2
+    const double logCoefs[] = {
+        2.0 / 23, 2.0 / 21, 2.0 / 19, 2.0 / 17, 2.0 / 15, 2.0 / 13, 2.0 / 11, 2.0 / 9, 2.0 / 7, 2.0 / 5, 2.0 / 3
+    };
+    const size_t logTerms = sizeof(logCoefs) / sizeof(logCoefs[0]);
+
+    inline double fromBits(uint64_t bits)
+    {
+        double val;
+        memcpy(&val, &bits, sizeof(val));
+        return val;
+    }
+
+    inline uint64_t toBits(double val)
+    {
+        uint64_t bits;
+        memcpy(&bits, &val, sizeof(bits));
+        return bits;
+    }
+
+    // 2^k for integer k in [-1022, 1023]
+    inline double pow2Scalar(double k)
+    {
+        return fromBits(toBits(k + exponentMagic) << 52);
+    }
+
+    inline double expScalar(double x)
+    {
+        x = x < expMin ? expMin : x;
+        x = x > expMax ? expMax : x;
+
+        const double k = (x * log2e + roundMagic) - roundMagic;
+        const double r = (x - k * ln2Hi) - k * ln2Lo;
+
+        double p = expCoefs[0];
+        for (size_t c = 1; c < expTerms; ++c)
+            p = p * r + expCoefs[c];
+
+        // 2^k is split into two factors, so both of them stay normal when the result is subnormal
+        const double k1 = (k * 0.5 + roundMagic) - roundMagic;
+        return p * pow2Scalar(k1) * pow2Scalar(k - k1);
+    }
+
+    inline double logScalar(double x)
+    {
+        if (!(x > 0))
+            return x == 0 ? -HUGE_VAL : std::nan("");
+        if (x == HUGE_VAL)
+            return x;
+
+        double e = 0;
+        if (x < DBL_MIN)
+        {
+            x *= subnormalScale;
+            e = -52;
+        }
+
+        const uint64_t bits = toBits(x);
+        e += fromBits((bits >> 52) | twoPow52Bits) - exponentBias;
+
+        double m = fromBits((bits & mantissaMask) | oneBits);
+        if (m > sqrt2)
+        {
+            m *= 0.5;
+            e += 1;
+        }
+
+        const double f = m - 1;
+        const double s = f / (2 + f);
+        const double z = s * s;
+        double p = logCoefs[0];
+        for (size_t c = 1; c < logTerms; ++c)
+            p = p * z + logCoefs[c];
+
+        // 2s = f - s * f, so log(m) = f - hfsq + s * (hfsq + z * P(z)) keeps f exact and rounds only the small terms
+        const double hfsq = 0.5 * f * f;
+        return e * ln2Hi - ((hfsq - (s * (hfsq + z * p) + e * ln2Lo)) - f);
+    }
+
+    void absValuesScalar(double* dst, const double* a, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = std::fabs(a[i]);
+    }
+
+    void sqrtValuesScalar(double* dst, const double* a, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = std::sqrt(a[i]);
+    }
+
+    void expValuesScalar(double* dst, const double* a, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = expScalar(a[i]);
+    }
+
+    void logValuesScalar(double* dst, const double* a, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = logScalar(a[i]);
+    }
+
+    void sigmoidValuesScalar(double* dst, const double* a, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+            dst[i] = 1 / (1 + expScalar(-a[i]));
+    }
+
+    void clampValuesScalar(double* dst, const double* a, double lower, double upper, size_t n)
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            const double val = a[i] < lower ? lower : a[i];
+            dst[i] = val > upper ? upper : val;
+        }
+    }
+
+    ///////////////////Scalar sparse-dense kernels/////////////////
+
+    double gatherDotScalar(const double* values, const size_t* indices, const double* dense, size_t nnz)
+    {
+        double s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+        size_t k = 0;
+        for (; k + 4 <= nnz; k += 4)
+        {
+            s0 += values[k] * dense[indices[k]];
+            s1 += values[k + 1] * dense[indices[k + 1]];
+            s2 += values[k + 2] * dense[indices[k + 2]];
+            s3 += values[k + 3] * dense[indices[k + 3]];
+        }
+        for (; k < nnz; ++k)
+            s0 += values[k] * dense[indices[k]];
+        return (s0 + s1) + (s2 + s3);
+    }
+
+    void scatterAxpyScalar(double* dense, const size_t* indices, const double* values, double c, size_t nnz)
+    {
+        for (size_t k = 0; k < nnz; ++k)
+            dense[indices[k]] += c * values[k];
+    }
+
+    bool scatterAxpyIsFiniteScalar(const double* dense, const size_t* indices, const double* values, double c, size_t nnz)
+    {
+        double acc = 0;
+        for (size_t k = 0; k < nnz; ++k)
+        {
+            const double r = dense[indices[k]] + c * values[k];
+            acc += r - r;
+        }
+        return acc == 0;
+    }
+
+#ifdef VECTOR_KERNELS_X86
+
+    ///////////////////SSE2/////////////////
+
+    KERNEL_TARGET("sse2") inline double hsumSse2(__m128d v)
+    {
+        return _mm_cvtsd_f64(_mm_add_sd(v, _mm_unpackhi_pd(v, v)));
+    }
+
+    KERNEL_TARGET("sse2") inline bool allZeroSse2(__m128d v)
+    {
+        return _mm_movemask_pd(_mm_cmpeq_pd(v, _mm_setzero_pd())) == 0x3;
+    }
+
+    KERNEL_TARGET("sse2") void combineSse2(double* dst, const double* a, const double* b, double sign, size_t n)
+    {
+        const __m128d s = _mm_set1_pd(sign);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(a + i), _mm_mul_pd(s, _mm_loadu_pd(b + i))));
+        for (; i < n; ++i)
+            dst[i] = a[i] + sign * b[i];
+    }
+
+    KERNEL_TARGET("sse2") bool combineIsFiniteSse2(const double* a, const double* b, double sign, size_t n)
+    {
+        const __m128d s = _mm_set1_pd(sign);
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d r = _mm_add_pd(_mm_loadu_pd(a + i), _mm_mul_pd(s, _mm_loadu_pd(b + i)));
+            bad = _mm_or_pd(bad, _mm_sub_pd(r, r));
+        }
+        return allZeroSse2(bad) && combineIsFiniteScalar(a + i, b + i, sign, n - i);
+    }
+
+    KERNEL_TARGET("sse2") bool combineCheckedSse2(double* dst, const double* a, const double* b, double sign, size_t n)
+    {
+        const __m128d s = _mm_set1_pd(sign);
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d r = _mm_add_pd(_mm_loadu_pd(a + i), _mm_mul_pd(s, _mm_loadu_pd(b + i)));
+            _mm_storeu_pd(dst + i, r);
+            bad = _mm_or_pd(bad, _mm_sub_pd(r, r));
+        }
+        return allZeroSse2(bad) && combineCheckedScalar(dst + i, a + i, b + i, sign, n - i);
+    }
+
+    KERNEL_TARGET("sse2") inline __m128d linearAtSse2(const double* coefs, const double* const* srcs, size_t count, size_t i)
+    {
+        __m128d acc = _mm_setzero_pd();
+        for (size_t t = 0; t < count; ++t)
+            acc = _mm_add_pd(acc, _mm_mul_pd(_mm_set1_pd(coefs[t]), _mm_loadu_pd(srcs[t] + i)));
+        return acc;
+    }
+
+    KERNEL_TARGET("sse2") void linearSse2(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, linearAtSse2(coefs, srcs, count, i));
+        linearRange(dst, coefs, srcs, count, i, n);
+    }
+
+    KERNEL_TARGET("sse2") bool linearIsFiniteSse2(const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d r = linearAtSse2(coefs, srcs, count, i);
+            bad = _mm_or_pd(bad, _mm_sub_pd(r, r));
+        }
+        return allZeroSse2(bad) && linearIsFiniteRange(coefs, srcs, count, i, n);
+    }
+
+    KERNEL_TARGET("sse2") bool linearCheckedSse2(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d r = linearAtSse2(coefs, srcs, count, i);
+            _mm_storeu_pd(dst + i, r);
+            bad = _mm_or_pd(bad, _mm_sub_pd(r, r));
+        }
+        return allZeroSse2(bad) && linearCheckedRange(dst, coefs, srcs, count, i, n);
+    }
+
+    KERNEL_TARGET("sse2") void scaleSse2(double* dst, const double* a, double multiplier, size_t n)
+    {
+        const __m128d m = _mm_set1_pd(multiplier);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, _mm_mul_pd(_mm_loadu_pd(a + i), m));
+        for (; i < n; ++i)
+            dst[i] = a[i] * multiplier;
+    }
+
+    KERNEL_TARGET("sse2") bool scaleIsFiniteSse2(const double* a, double multiplier, size_t n)
+    {
+        const __m128d m = _mm_set1_pd(multiplier);
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d r = _mm_mul_pd(_mm_loadu_pd(a + i), m);
+            bad = _mm_or_pd(bad, _mm_sub_pd(r, r));
+        }
+        return allZeroSse2(bad) && scaleIsFiniteScalar(a + i, multiplier, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void shiftSse2(double* dst, const double* a, double c, size_t n)
+    {
+        const __m128d s = _mm_set1_pd(c);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, _mm_add_pd(_mm_loadu_pd(a + i), s));
+        for (; i < n; ++i)
+            dst[i] = a[i] + c;
+    }
+
+    KERNEL_TARGET("sse2") bool shiftIsFiniteSse2(const double* a, double c, size_t n)
+    {
+        const __m128d s = _mm_set1_pd(c);
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d r = _mm_add_pd(_mm_loadu_pd(a + i), s);
+            bad = _mm_or_pd(bad, _mm_sub_pd(r, r));
+        }
+        return allZeroSse2(bad) && shiftIsFiniteScalar(a + i, c, n - i);
+    }
+
+    KERNEL_TARGET("sse2") bool isFiniteSse2(const double* a, size_t n)
+    {
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d r = _mm_loadu_pd(a + i);
+            bad = _mm_or_pd(bad, _mm_sub_pd(r, r));
+        }
+        return allZeroSse2(bad) && isFiniteScalar(a + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double dotSse2(const double* a, const double* b, size_t n)
+    {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2)));
+            s2 = _mm_add_pd(s2, _mm_mul_pd(_mm_loadu_pd(a + i + 4), _mm_loadu_pd(b + i + 4)));
+            s3 = _mm_add_pd(s3, _mm_mul_pd(_mm_loadu_pd(a + i + 6), _mm_loadu_pd(b + i + 6)));
+        }
+        for (; i + 2 <= n; i += 2)
+            s0 = _mm_add_pd(s0, _mm_mul_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+        return hsumSse2(_mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3))) + dotScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double sumAbsSse2(const double* a, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd(), s2 = _mm_setzero_pd(), s3 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm_add_pd(s0, _mm_andnot_pd(signMask, _mm_loadu_pd(a + i)));
+            s1 = _mm_add_pd(s1, _mm_andnot_pd(signMask, _mm_loadu_pd(a + i + 2)));
+            s2 = _mm_add_pd(s2, _mm_andnot_pd(signMask, _mm_loadu_pd(a + i + 4)));
+            s3 = _mm_add_pd(s3, _mm_andnot_pd(signMask, _mm_loadu_pd(a + i + 6)));
+        }
+        for (; i + 2 <= n; i += 2)
+            s0 = _mm_add_pd(s0, _mm_andnot_pd(signMask, _mm_loadu_pd(a + i)));
+        return hsumSse2(_mm_add_pd(_mm_add_pd(s0, s1), _mm_add_pd(s2, s3))) + sumAbsScalar(a + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double sumSquaresSse2(const double* a, size_t n)
+    {
+        return dotSse2(a, a, n);
+    }
+
+    KERNEL_TARGET("sse2") double maxAbsSse2(const double* a, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        __m128d m0 = _mm_setzero_pd(), m1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            m0 = _mm_max_pd(m0, _mm_andnot_pd(signMask, _mm_loadu_pd(a + i)));
+            m1 = _mm_max_pd(m1, _mm_andnot_pd(signMask, _mm_loadu_pd(a + i + 2)));
+        }
+        m0 = _mm_max_pd(m0, m1);
+        m0 = _mm_max_sd(m0, _mm_unpackhi_pd(m0, m0));
+        const double head = _mm_cvtsd_f64(m0);
+        const double tail = maxAbsScalar(a + i, n - i);
+        return head > tail ? head : tail;
+    }
+
+    KERNEL_TARGET("sse2") double sumAbsDiffSse2(const double* a, const double* b, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            s0 = _mm_add_pd(s0, _mm_andnot_pd(signMask, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i))));
+            s1 = _mm_add_pd(s1, _mm_andnot_pd(signMask, _mm_sub_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2))));
+        }
+        return hsumSse2(_mm_add_pd(s0, s1)) + sumAbsDiffScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double sumSquaresDiffSse2(const double* a, const double* b, size_t n)
+    {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m128d d0 = _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i));
+            const __m128d d1 = _mm_sub_pd(_mm_loadu_pd(a + i + 2), _mm_loadu_pd(b + i + 2));
+            s0 = _mm_add_pd(s0, _mm_mul_pd(d0, d0));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(d1, d1));
+        }
+        return hsumSse2(_mm_add_pd(s0, s1)) + sumSquaresDiffScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double maxAbsDiffSse2(const double* a, const double* b, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        __m128d m = _mm_setzero_pd();
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d d = _mm_andnot_pd(signMask, _mm_sub_pd(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i)));
+            m = _mm_max_pd(m, d);
+            bad = _mm_or_pd(bad, _mm_cmpunord_pd(d, d));
+        }
+        m = _mm_max_sd(m, _mm_unpackhi_pd(m, m));
+        const double head = _mm_movemask_pd(bad) != 0 ? std::nan("") : _mm_cvtsd_f64(m);
+        const double tail = maxAbsDiffScalar(a + i, b + i, n - i);
+        if (std::isnan(head) || std::isnan(tail))
+            return std::nan("");
+        return head > tail ? head : tail;
+    }
+
+    KERNEL_TARGET("sse2") void columnSumAbsDiffSse2(double* acc, const double* col, double c, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        const __m128d cv = _mm_set1_pd(c);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d d = _mm_andnot_pd(signMask, _mm_sub_pd(_mm_loadu_pd(col + i), cv));
+            _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), d));
+        }
+        columnSumAbsDiffScalar(acc + i, col + i, c, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void columnSumSquaresDiffSse2(double* acc, const double* col, double c, size_t n)
+    {
+        const __m128d cv = _mm_set1_pd(c);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d d = _mm_sub_pd(_mm_loadu_pd(col + i), cv);
+            _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), _mm_mul_pd(d, d)));
+        }
+        columnSumSquaresDiffScalar(acc + i, col + i, c, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void columnMaxAbsDiffSse2(double* acc, const double* col, double c, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        const __m128d cv = _mm_set1_pd(c);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d d = _mm_andnot_pd(signMask, _mm_sub_pd(_mm_loadu_pd(col + i), cv));
+            _mm_storeu_pd(acc + i, _mm_max_pd(_mm_loadu_pd(acc + i), d));
+        }
+        columnMaxAbsDiffScalar(acc + i, col + i, c, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void columnAxpySse2(double* acc, const double* col, double c, size_t n)
+    {
+        const __m128d cv = _mm_set1_pd(c);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(acc + i, _mm_add_pd(_mm_loadu_pd(acc + i), _mm_mul_pd(cv, _mm_loadu_pd(col + i))));
+        columnAxpyScalar(acc + i, col + i, c, n - i);
+    }
+
+    // Four floats are widened to two pairs of doubles
+
+    KERNEL_TARGET("sse2") inline void loadFloatsSse2(const float* p, __m128d& lo, __m128d& hi)
+    {
+        const __m128 v = _mm_loadu_ps(p);
+        lo = _mm_cvtps_pd(v);
+        hi = _mm_cvtps_pd(_mm_movehl_ps(v, v));
+    }
+
+    KERNEL_TARGET("sse2") double dotFloatSse2(const float* a, const float* b, size_t n)
+    {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128d a0, a1, b0, b1;
+            loadFloatsSse2(a + i, a0, a1);
+            loadFloatsSse2(b + i, b0, b1);
+            s0 = _mm_add_pd(s0, _mm_mul_pd(a0, b0));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(a1, b1));
+        }
+        return hsumSse2(_mm_add_pd(s0, s1)) + dotFloatScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double dotMixedSse2(const float* a, const double* b, size_t n)
+    {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128d a0, a1;
+            loadFloatsSse2(a + i, a0, a1);
+            s0 = _mm_add_pd(s0, _mm_mul_pd(a0, _mm_loadu_pd(b + i)));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(a1, _mm_loadu_pd(b + i + 2)));
+        }
+        return hsumSse2(_mm_add_pd(s0, s1)) + dotMixedScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double sumAbsFloatSse2(const float* a, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128d a0, a1;
+            loadFloatsSse2(a + i, a0, a1);
+            s0 = _mm_add_pd(s0, _mm_andnot_pd(signMask, a0));
+            s1 = _mm_add_pd(s1, _mm_andnot_pd(signMask, a1));
+        }
+        return hsumSse2(_mm_add_pd(s0, s1)) + sumAbsFloatScalar(a + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double sumSquaresFloatSse2(const float* a, size_t n)
+    {
+        return dotFloatSse2(a, a, n);
+    }
+
+    KERNEL_TARGET("sse2") double maxAbsFloatSse2(const float* a, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        __m128d m0 = _mm_setzero_pd(), m1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128d a0, a1;
+            loadFloatsSse2(a + i, a0, a1);
+            m0 = _mm_max_pd(m0, _mm_andnot_pd(signMask, a0));
+            m1 = _mm_max_pd(m1, _mm_andnot_pd(signMask, a1));
+        }
+        m0 = _mm_max_pd(m0, m1);
+        m0 = _mm_max_sd(m0, _mm_unpackhi_pd(m0, m0));
+        const double head = _mm_cvtsd_f64(m0);
+        const double tail = maxAbsFloatScalar(a + i, n - i);
+        return head > tail ? head : tail;
+    }
+
+    KERNEL_TARGET("sse2") double sumAbsDiffFloatSse2(const float* a, const float* b, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128d a0, a1, b0, b1;
+            loadFloatsSse2(a + i, a0, a1);
+            loadFloatsSse2(b + i, b0, b1);
+            s0 = _mm_add_pd(s0, _mm_andnot_pd(signMask, _mm_sub_pd(a0, b0)));
+            s1 = _mm_add_pd(s1, _mm_andnot_pd(signMask, _mm_sub_pd(a1, b1)));
+        }
+        return hsumSse2(_mm_add_pd(s0, s1)) + sumAbsDiffFloatScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double sumSquaresDiffFloatSse2(const float* a, const float* b, size_t n)
+    {
+        __m128d s0 = _mm_setzero_pd(), s1 = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128d a0, a1, b0, b1;
+            loadFloatsSse2(a + i, a0, a1);
+            loadFloatsSse2(b + i, b0, b1);
+            const __m128d d0 = _mm_sub_pd(a0, b0), d1 = _mm_sub_pd(a1, b1);
+            s0 = _mm_add_pd(s0, _mm_mul_pd(d0, d0));
+            s1 = _mm_add_pd(s1, _mm_mul_pd(d1, d1));
+        }
+        return hsumSse2(_mm_add_pd(s0, s1)) + sumSquaresDiffFloatScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") double maxAbsDiffFloatSse2(const float* a, const float* b, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        __m128d m = _mm_setzero_pd();
+        __m128d bad = _mm_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            __m128d a0, a1, b0, b1;
+            loadFloatsSse2(a + i, a0, a1);
+            loadFloatsSse2(b + i, b0, b1);
+            const __m128d d0 = _mm_andnot_pd(signMask, _mm_sub_pd(a0, b0));
+            const __m128d d1 = _mm_andnot_pd(signMask, _mm_sub_pd(a1, b1));
+            m = _mm_max_pd(m, _mm_max_pd(d0, d1));
+            bad = _mm_or_pd(bad, _mm_or_pd(_mm_cmpunord_pd(d0, d0), _mm_cmpunord_pd(d1, d1)));
+        }
+        m = _mm_max_sd(m, _mm_unpackhi_pd(m, m));
+        const double head = _mm_movemask_pd(bad) != 0 ? std::nan("") : _mm_cvtsd_f64(m);
+        const double tail = maxAbsDiffFloatScalar(a + i, b + i, n - i);
+        if (std::isnan(head) || std::isnan(tail))
+            return std::nan("");
+        return head > tail ? head : tail;
+    }
+
+    KERNEL_TARGET("sse2") inline __m128d pow2Sse2(__m128d k)
+    {
+        return _mm_castsi128_pd(_mm_slli_epi64(_mm_castpd_si128(_mm_add_pd(k, _mm_set1_pd(exponentMagic))), 52));
+    }
+
+    // Same steps as expScalar, max and min return their second operand for NaN, so NaN goes through
+    KERNEL_TARGET("sse2") inline __m128d expSse2(__m128d x)
+    {
+        const __m128d magic = _mm_set1_pd(roundMagic);
+        x = _mm_min_pd(_mm_set1_pd(expMax), _mm_max_pd(_mm_set1_pd(expMin), x));
+
+        const __m128d k = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(x, _mm_set1_pd(log2e)), magic), magic);
+        const __m128d r = _mm_sub_pd(_mm_sub_pd(x, _mm_mul_pd(k, _mm_set1_pd(ln2Hi))), _mm_mul_pd(k, _mm_set1_pd(ln2Lo)));
+
+        __m128d p = _mm_set1_pd(expCoefs[0]);
+        for (size_t c = 1; c < expTerms; ++c)
+            p = _mm_add_pd(_mm_mul_pd(p, r), _mm_set1_pd(expCoefs[c]));
+
+        const __m128d k1 = _mm_sub_pd(_mm_add_pd(_mm_mul_pd(k, _mm_set1_pd(0.5)), magic), magic);
+        return _mm_mul_pd(_mm_mul_pd(p, pow2Sse2(k1)), pow2Sse2(_mm_sub_pd(k, k1)));
+    }
+
+    KERNEL_TARGET("sse2") inline __m128d selectSse2(__m128d mask, __m128d a, __m128d b)
+    {
+        return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+    }
+
+    KERNEL_TARGET("sse2") inline __m128d logSse2(__m128d x)
+    {
+        const __m128d one = _mm_set1_pd(1.0);
+        const __m128d tiny = _mm_cmplt_pd(x, _mm_set1_pd(DBL_MIN));
+        const __m128d y = selectSse2(tiny, _mm_mul_pd(x, _mm_set1_pd(subnormalScale)), x);
+        const __m128i bits = _mm_castpd_si128(y);
+
+        __m128d e = _mm_and_pd(tiny, _mm_set1_pd(-52.0));
+        const __m128i exponent = _mm_or_si128(_mm_srli_epi64(bits, 52), _mm_set1_epi64x((long long)twoPow52Bits));
+        e = _mm_add_pd(e, _mm_sub_pd(_mm_castsi128_pd(exponent), _mm_set1_pd(exponentBias)));
+
+        __m128d m = _mm_castsi128_pd(_mm_or_si128(_mm_and_si128(bits, _mm_set1_epi64x((long long)mantissaMask)),
+                                                  _mm_set1_epi64x((long long)oneBits)));
+        const __m128d big = _mm_cmpgt_pd(m, _mm_set1_pd(sqrt2));
+        m = selectSse2(big, _mm_mul_pd(m, _mm_set1_pd(0.5)), m);
+        e = _mm_add_pd(e, _mm_and_pd(big, one));
+
+        const __m128d f = _mm_sub_pd(m, one);
+        const __m128d s = _mm_div_pd(f, _mm_add_pd(_mm_set1_pd(2.0), f));
+        const __m128d z = _mm_mul_pd(s, s);
+        __m128d p = _mm_set1_pd(logCoefs[0]);
+        for (size_t c = 1; c < logTerms; ++c)
+            p = _mm_add_pd(_mm_mul_pd(p, z), _mm_set1_pd(logCoefs[c]));
+
+        const __m128d hfsq = _mm_mul_pd(_mm_mul_pd(_mm_set1_pd(0.5), f), f);
+        const __m128d tail = _mm_add_pd(_mm_mul_pd(s, _mm_add_pd(hfsq, _mm_mul_pd(z, p))), _mm_mul_pd(e, _mm_set1_pd(ln2Lo)));
+        __m128d result = _mm_sub_pd(_mm_mul_pd(e, _mm_set1_pd(ln2Hi)), _mm_sub_pd(_mm_sub_pd(hfsq, tail), f));
+
+        const __m128d inf = _mm_set1_pd(HUGE_VAL);
+        result = selectSse2(_mm_cmpeq_pd(x, inf), inf, result);
+        result = selectSse2(_mm_cmpeq_pd(x, _mm_setzero_pd()), _mm_set1_pd(-HUGE_VAL), result);
+        return selectSse2(_mm_cmpnge_pd(x, _mm_setzero_pd()), _mm_set1_pd(std::nan("")), result);
+    }
+
+    KERNEL_TARGET("sse2") void absValuesSse2(double* dst, const double* a, size_t n)
+    {
+        const __m128d signMask = _mm_set1_pd(-0.0);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, _mm_andnot_pd(signMask, _mm_loadu_pd(a + i)));
+        absValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void sqrtValuesSse2(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, _mm_sqrt_pd(_mm_loadu_pd(a + i)));
+        sqrtValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void expValuesSse2(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, expSse2(_mm_loadu_pd(a + i)));
+        expValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void logValuesSse2(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, logSse2(_mm_loadu_pd(a + i)));
+        logValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void sigmoidValuesSse2(double* dst, const double* a, size_t n)
+    {
+        const __m128d one = _mm_set1_pd(1.0);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+        {
+            const __m128d e = expSse2(_mm_sub_pd(_mm_setzero_pd(), _mm_loadu_pd(a + i)));
+            _mm_storeu_pd(dst + i, _mm_div_pd(one, _mm_add_pd(one, e)));
+        }
+        sigmoidValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("sse2") void clampValuesSse2(double* dst, const double* a, double lower, double upper, size_t n)
+    {
+        const __m128d lo = _mm_set1_pd(lower);
+        const __m128d hi = _mm_set1_pd(upper);
+        size_t i = 0;
+        for (; i + 2 <= n; i += 2)
+            _mm_storeu_pd(dst + i, _mm_min_pd(hi, _mm_max_pd(lo, _mm_loadu_pd(a + i))));
+        clampValuesScalar(dst + i, a + i, lower, upper, n - i);
+    }
+
+    ///////////////////AVX2/////////////////
+
+    KERNEL_TARGET("avx2") inline double hsumAvx2(__m256d v)
+    {
+        const __m128d sum = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+        return _mm_cvtsd_f64(_mm_add_sd(sum, _mm_unpackhi_pd(sum, sum)));
+    }
+
+    KERNEL_TARGET("avx2") inline bool allZeroAvx2(__m256d v)
+    {
+        return _mm256_movemask_pd(_mm256_cmp_pd(v, _mm256_setzero_pd(), _CMP_EQ_OQ)) == 0xF;
+    }
+
+    KERNEL_TARGET("avx2") void combineAvx2(double* dst, const double* a, const double* b, double sign, size_t n)
+    {
+        const __m256d s = _mm256_set1_pd(sign);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_mul_pd(s, _mm256_loadu_pd(b + i))));
+        for (; i < n; ++i)
+            dst[i] = a[i] + sign * b[i];
+    }
+
+    KERNEL_TARGET("avx2") bool combineIsFiniteAvx2(const double* a, const double* b, double sign, size_t n)
+    {
+        const __m256d s = _mm256_set1_pd(sign);
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d r = _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_mul_pd(s, _mm256_loadu_pd(b + i)));
+            bad = _mm256_or_pd(bad, _mm256_sub_pd(r, r));
+        }
+        return allZeroAvx2(bad) && combineIsFiniteScalar(a + i, b + i, sign, n - i);
+    }
+
+    KERNEL_TARGET("avx2") bool combineCheckedAvx2(double* dst, const double* a, const double* b, double sign, size_t n)
+    {
+        const __m256d s = _mm256_set1_pd(sign);
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d r = _mm256_add_pd(_mm256_loadu_pd(a + i), _mm256_mul_pd(s, _mm256_loadu_pd(b + i)));
+            _mm256_storeu_pd(dst + i, r);
+            bad = _mm256_or_pd(bad, _mm256_sub_pd(r, r));
+        }
+        return allZeroAvx2(bad) && combineCheckedScalar(dst + i, a + i, b + i, sign, n - i);
+    }
+
+    KERNEL_TARGET("avx2") inline __m256d linearAtAvx2(const double* coefs, const double* const* srcs, size_t count, size_t i)
+    {
+        __m256d acc = _mm256_setzero_pd();
+        for (size_t t = 0; t < count; ++t)
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_set1_pd(coefs[t]), _mm256_loadu_pd(srcs[t] + i)));
+        return acc;
+    }
+
+    KERNEL_TARGET("avx2") void linearAvx2(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, linearAtAvx2(coefs, srcs, count, i));
+        linearRange(dst, coefs, srcs, count, i, n);
+    }
+
+    KERNEL_TARGET("avx2") bool linearIsFiniteAvx2(const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d r = linearAtAvx2(coefs, srcs, count, i);
+            bad = _mm256_or_pd(bad, _mm256_sub_pd(r, r));
+        }
+        return allZeroAvx2(bad) && linearIsFiniteRange(coefs, srcs, count, i, n);
+    }
+
+    KERNEL_TARGET("avx2") bool linearCheckedAvx2(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n)
+    {
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d r = linearAtAvx2(coefs, srcs, count, i);
+            _mm256_storeu_pd(dst + i, r);
+            bad = _mm256_or_pd(bad, _mm256_sub_pd(r, r));
+        }
+        return allZeroAvx2(bad) && linearCheckedRange(dst, coefs, srcs, count, i, n);
+    }
+
+    KERNEL_TARGET("avx2") void scaleAvx2(double* dst, const double* a, double multiplier, size_t n)
+    {
+        const __m256d m = _mm256_set1_pd(multiplier);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, _mm256_mul_pd(_mm256_loadu_pd(a + i), m));
+        for (; i < n; ++i)
+            dst[i] = a[i] * multiplier;
+    }
+
+    KERNEL_TARGET("avx2") bool scaleIsFiniteAvx2(const double* a, double multiplier, size_t n)
+    {
+        const __m256d m = _mm256_set1_pd(multiplier);
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d r = _mm256_mul_pd(_mm256_loadu_pd(a + i), m);
+            bad = _mm256_or_pd(bad, _mm256_sub_pd(r, r));
+        }
+        return allZeroAvx2(bad) && scaleIsFiniteScalar(a + i, multiplier, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void shiftAvx2(double* dst, const double* a, double c, size_t n)
+    {
+        const __m256d s = _mm256_set1_pd(c);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, _mm256_add_pd(_mm256_loadu_pd(a + i), s));
+        for (; i < n; ++i)
+            dst[i] = a[i] + c;
+    }
+
+    KERNEL_TARGET("avx2") bool shiftIsFiniteAvx2(const double* a, double c, size_t n)
+    {
+        const __m256d s = _mm256_set1_pd(c);
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d r = _mm256_add_pd(_mm256_loadu_pd(a + i), s);
+            bad = _mm256_or_pd(bad, _mm256_sub_pd(r, r));
+        }
+        return allZeroAvx2(bad) && shiftIsFiniteScalar(a + i, c, n - i);
+    }
+
+    KERNEL_TARGET("avx2") bool isFiniteAvx2(const double* a, size_t n)
+    {
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d r = _mm256_loadu_pd(a + i);
+            bad = _mm256_or_pd(bad, _mm256_sub_pd(r, r));
+        }
+        return allZeroAvx2(bad) && isFiniteScalar(a + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double dotAvx2(const double* a, const double* b, size_t n)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+            s2 = _mm256_add_pd(s2, _mm256_mul_pd(_mm256_loadu_pd(a + i + 8), _mm256_loadu_pd(b + i + 8)));
+            s3 = _mm256_add_pd(s3, _mm256_mul_pd(_mm256_loadu_pd(a + i + 12), _mm256_loadu_pd(b + i + 12)));
+        }
+        for (; i + 4 <= n; i += 4)
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+        return hsumAvx2(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3))) + dotScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double sumAbsAvx2(const double* a, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd(), s2 = _mm256_setzero_pd(), s3 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm256_add_pd(s0, _mm256_andnot_pd(signMask, _mm256_loadu_pd(a + i)));
+            s1 = _mm256_add_pd(s1, _mm256_andnot_pd(signMask, _mm256_loadu_pd(a + i + 4)));
+            s2 = _mm256_add_pd(s2, _mm256_andnot_pd(signMask, _mm256_loadu_pd(a + i + 8)));
+            s3 = _mm256_add_pd(s3, _mm256_andnot_pd(signMask, _mm256_loadu_pd(a + i + 12)));
+        }
+        for (; i + 4 <= n; i += 4)
+            s0 = _mm256_add_pd(s0, _mm256_andnot_pd(signMask, _mm256_loadu_pd(a + i)));
+        return hsumAvx2(_mm256_add_pd(_mm256_add_pd(s0, s1), _mm256_add_pd(s2, s3))) + sumAbsScalar(a + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double sumSquaresAvx2(const double* a, size_t n)
+    {
+        return dotAvx2(a, a, n);
+    }
+
+    KERNEL_TARGET("avx2") double maxAbsAvx2(const double* a, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        __m256d m0 = _mm256_setzero_pd(), m1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            m0 = _mm256_max_pd(m0, _mm256_andnot_pd(signMask, _mm256_loadu_pd(a + i)));
+            m1 = _mm256_max_pd(m1, _mm256_andnot_pd(signMask, _mm256_loadu_pd(a + i + 4)));
+        }
+        m0 = _mm256_max_pd(m0, m1);
+        __m128d half = _mm_max_pd(_mm256_castpd256_pd128(m0), _mm256_extractf128_pd(m0, 1));
+        half = _mm_max_sd(half, _mm_unpackhi_pd(half, half));
+        const double head = _mm_cvtsd_f64(half);
+        const double tail = maxAbsScalar(a + i, n - i);
+        return head > tail ? head : tail;
+    }
+
+    KERNEL_TARGET("avx2") double sumAbsDiffAvx2(const double* a, const double* b, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm256_add_pd(s0, _mm256_andnot_pd(signMask, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i))));
+            s1 = _mm256_add_pd(s1, _mm256_andnot_pd(signMask,
+                                                    _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4))));
+        }
+        return hsumAvx2(_mm256_add_pd(s0, s1)) + sumAbsDiffScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double sumSquaresDiffAvx2(const double* a, const double* b, size_t n)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256d d0 = _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i));
+            const __m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(a + i + 4), _mm256_loadu_pd(b + i + 4));
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(d0, d0));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(d1, d1));
+        }
+        return hsumAvx2(_mm256_add_pd(s0, s1)) + sumSquaresDiffScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double maxAbsDiffAvx2(const double* a, const double* b, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        __m256d m = _mm256_setzero_pd();
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d d = _mm256_andnot_pd(signMask, _mm256_sub_pd(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i)));
+            m = _mm256_max_pd(m, d);
+            bad = _mm256_or_pd(bad, _mm256_cmp_pd(d, d, _CMP_UNORD_Q));
+        }
+        __m128d half = _mm_max_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+        half = _mm_max_sd(half, _mm_unpackhi_pd(half, half));
+        const double head = _mm256_movemask_pd(bad) != 0 ? std::nan("") : _mm_cvtsd_f64(half);
+        const double tail = maxAbsDiffScalar(a + i, b + i, n - i);
+        if (std::isnan(head) || std::isnan(tail))
+            return std::nan("");
+        return head > tail ? head : tail;
+    }
+
+    KERNEL_TARGET("avx2") void columnSumAbsDiffAvx2(double* acc, const double* col, double c, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        const __m256d cv = _mm256_set1_pd(c);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d d = _mm256_andnot_pd(signMask, _mm256_sub_pd(_mm256_loadu_pd(col + i), cv));
+            _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), d));
+        }
+        columnSumAbsDiffScalar(acc + i, col + i, c, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void columnSumSquaresDiffAvx2(double* acc, const double* col, double c, size_t n)
+    {
+        const __m256d cv = _mm256_set1_pd(c);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d d = _mm256_sub_pd(_mm256_loadu_pd(col + i), cv);
+            _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), _mm256_mul_pd(d, d)));
+        }
+        columnSumSquaresDiffScalar(acc + i, col + i, c, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void columnMaxAbsDiffAvx2(double* acc, const double* col, double c, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        const __m256d cv = _mm256_set1_pd(c);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d d = _mm256_andnot_pd(signMask, _mm256_sub_pd(_mm256_loadu_pd(col + i), cv));
+            _mm256_storeu_pd(acc + i, _mm256_max_pd(_mm256_loadu_pd(acc + i), d));
+        }
+        columnMaxAbsDiffScalar(acc + i, col + i, c, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void columnAxpyAvx2(double* acc, const double* col, double c, size_t n)
+    {
+        const __m256d cv = _mm256_set1_pd(c);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(acc + i, _mm256_add_pd(_mm256_loadu_pd(acc + i), _mm256_mul_pd(cv, _mm256_loadu_pd(col + i))));
+        columnAxpyScalar(acc + i, col + i, c, n - i);
+    }
+
+    KERNEL_TARGET("avx2") inline __m256d loadFloatsAvx2(const float* p)
+    {
+        return _mm256_cvtps_pd(_mm_loadu_ps(p));
+    }
+
+    KERNEL_TARGET("avx2") double dotFloatAvx2(const float* a, const float* b, size_t n)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(loadFloatsAvx2(a + i), loadFloatsAvx2(b + i)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(loadFloatsAvx2(a + i + 4), loadFloatsAvx2(b + i + 4)));
+        }
+        return hsumAvx2(_mm256_add_pd(s0, s1)) + dotFloatScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double dotMixedAvx2(const float* a, const double* b, size_t n)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(loadFloatsAvx2(a + i), _mm256_loadu_pd(b + i)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(loadFloatsAvx2(a + i + 4), _mm256_loadu_pd(b + i + 4)));
+        }
+        return hsumAvx2(_mm256_add_pd(s0, s1)) + dotMixedScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double sumAbsFloatAvx2(const float* a, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm256_add_pd(s0, _mm256_andnot_pd(signMask, loadFloatsAvx2(a + i)));
+            s1 = _mm256_add_pd(s1, _mm256_andnot_pd(signMask, loadFloatsAvx2(a + i + 4)));
+        }
+        return hsumAvx2(_mm256_add_pd(s0, s1)) + sumAbsFloatScalar(a + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double sumSquaresFloatAvx2(const float* a, size_t n)
+    {
+        return dotFloatAvx2(a, a, n);
+    }
+
+    KERNEL_TARGET("avx2") double maxAbsFloatAvx2(const float* a, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        __m256d m0 = _mm256_setzero_pd(), m1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            m0 = _mm256_max_pd(m0, _mm256_andnot_pd(signMask, loadFloatsAvx2(a + i)));
+            m1 = _mm256_max_pd(m1, _mm256_andnot_pd(signMask, loadFloatsAvx2(a + i + 4)));
+        }
+        m0 = _mm256_max_pd(m0, m1);
+        __m128d half = _mm_max_pd(_mm256_castpd256_pd128(m0), _mm256_extractf128_pd(m0, 1));
+        half = _mm_max_sd(half, _mm_unpackhi_pd(half, half));
+        const double head = _mm_cvtsd_f64(half);
+        const double tail = maxAbsFloatScalar(a + i, n - i);
+        return head > tail ? head : tail;
+    }
+
+    KERNEL_TARGET("avx2") double sumAbsDiffFloatAvx2(const float* a, const float* b, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            s0 = _mm256_add_pd(s0, _mm256_andnot_pd(signMask, _mm256_sub_pd(loadFloatsAvx2(a + i), loadFloatsAvx2(b + i))));
+            s1 = _mm256_add_pd(s1, _mm256_andnot_pd(signMask, _mm256_sub_pd(loadFloatsAvx2(a + i + 4), loadFloatsAvx2(b + i + 4))));
+        }
+        return hsumAvx2(_mm256_add_pd(s0, s1)) + sumAbsDiffFloatScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double sumSquaresDiffFloatAvx2(const float* a, const float* b, size_t n)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m256d d0 = _mm256_sub_pd(loadFloatsAvx2(a + i), loadFloatsAvx2(b + i));
+            const __m256d d1 = _mm256_sub_pd(loadFloatsAvx2(a + i + 4), loadFloatsAvx2(b + i + 4));
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(d0, d0));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(d1, d1));
+        }
+        return hsumAvx2(_mm256_add_pd(s0, s1)) + sumSquaresDiffFloatScalar(a + i, b + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") double maxAbsDiffFloatAvx2(const float* a, const float* b, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        __m256d m = _mm256_setzero_pd();
+        __m256d bad = _mm256_setzero_pd();
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d d = _mm256_andnot_pd(signMask, _mm256_sub_pd(loadFloatsAvx2(a + i), loadFloatsAvx2(b + i)));
+            m = _mm256_max_pd(m, d);
+            bad = _mm256_or_pd(bad, _mm256_cmp_pd(d, d, _CMP_UNORD_Q));
+        }
+        __m128d half = _mm_max_pd(_mm256_castpd256_pd128(m), _mm256_extractf128_pd(m, 1));
+        half = _mm_max_sd(half, _mm_unpackhi_pd(half, half));
+        const double head = _mm256_movemask_pd(bad) != 0 ? std::nan("") : _mm_cvtsd_f64(half);
+        const double tail = maxAbsDiffFloatScalar(a + i, b + i, n - i);
+        if (std::isnan(head) || std::isnan(tail))
+            return std::nan("");
+        return head > tail ? head : tail;
+    }
+
+    KERNEL_TARGET("avx2") inline __m256d pow2Avx2(__m256d k)
+    {
+        return _mm256_castsi256_pd(_mm256_slli_epi64(_mm256_castpd_si256(_mm256_add_pd(k, _mm256_set1_pd(exponentMagic))), 52));
+    }
+
+    KERNEL_TARGET("avx2") inline __m256d expAvx2(__m256d x)
+    {
+        const __m256d magic = _mm256_set1_pd(roundMagic);
+        x = _mm256_min_pd(_mm256_set1_pd(expMax), _mm256_max_pd(_mm256_set1_pd(expMin), x));
+
+        const __m256d k = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(x, _mm256_set1_pd(log2e)), magic), magic);
+        const __m256d r = _mm256_sub_pd(_mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(ln2Hi))), _mm256_mul_pd(k, _mm256_set1_pd(ln2Lo)));
+
+        __m256d p = _mm256_set1_pd(expCoefs[0]);
+        for (size_t c = 1; c < expTerms; ++c)
+            p = _mm256_add_pd(_mm256_mul_pd(p, r), _mm256_set1_pd(expCoefs[c]));
+
+        const __m256d k1 = _mm256_sub_pd(_mm256_add_pd(_mm256_mul_pd(k, _mm256_set1_pd(0.5)), magic), magic);
+        return _mm256_mul_pd(_mm256_mul_pd(p, pow2Avx2(k1)), pow2Avx2(_mm256_sub_pd(k, k1)));
+    }
+
+    KERNEL_TARGET("avx2") inline __m256d selectAvx2(__m256d mask, __m256d a, __m256d b)
+    {
+        return _mm256_blendv_pd(b, a, mask);
+    }
+
+    KERNEL_TARGET("avx2") inline __m256d logAvx2(__m256d x)
+    {
+        const __m256d one = _mm256_set1_pd(1.0);
+        const __m256d tiny = _mm256_cmp_pd(x, _mm256_set1_pd(DBL_MIN), _CMP_LT_OQ);
+        const __m256d y = selectAvx2(tiny, _mm256_mul_pd(x, _mm256_set1_pd(subnormalScale)), x);
+        const __m256i bits = _mm256_castpd_si256(y);
+
+        __m256d e = _mm256_and_pd(tiny, _mm256_set1_pd(-52.0));
+        const __m256i exponent = _mm256_or_si256(_mm256_srli_epi64(bits, 52), _mm256_set1_epi64x((long long)twoPow52Bits));
+        e = _mm256_add_pd(e, _mm256_sub_pd(_mm256_castsi256_pd(exponent), _mm256_set1_pd(exponentBias)));
+
+        __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi64x((long long)mantissaMask)),
+                                                  _mm256_set1_epi64x((long long)oneBits)));
+        const __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(sqrt2), _CMP_GT_OQ);
+        m = selectAvx2(big, _mm256_mul_pd(m, _mm256_set1_pd(0.5)), m);
+        e = _mm256_add_pd(e, _mm256_and_pd(big, one));
+
+        const __m256d f = _mm256_sub_pd(m, one);
+        const __m256d s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2.0), f));
+        const __m256d z = _mm256_mul_pd(s, s);
+        __m256d p = _mm256_set1_pd(logCoefs[0]);
+        for (size_t c = 1; c < logTerms; ++c)
+            p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(logCoefs[c]));
+
+        const __m256d hfsq = _mm256_mul_pd(_mm256_mul_pd(_mm256_set1_pd(0.5), f), f);
+        const __m256d tail = _mm256_add_pd(_mm256_mul_pd(s, _mm256_add_pd(hfsq, _mm256_mul_pd(z, p))),
+                                           _mm256_mul_pd(e, _mm256_set1_pd(ln2Lo)));
+        __m256d result = _mm256_sub_pd(_mm256_mul_pd(e, _mm256_set1_pd(ln2Hi)), _mm256_sub_pd(_mm256_sub_pd(hfsq, tail), f));
+
+        const __m256d inf = _mm256_set1_pd(HUGE_VAL);
+        result = selectAvx2(_mm256_cmp_pd(x, inf, _CMP_EQ_OQ), inf, result);
+        result = selectAvx2(_mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_EQ_OQ), _mm256_set1_pd(-HUGE_VAL), result);
+        return selectAvx2(_mm256_cmp_pd(x, _mm256_setzero_pd(), _CMP_NGE_UQ), _mm256_set1_pd(std::nan("")), result);
+    }
+
+    KERNEL_TARGET("avx2") void absValuesAvx2(double* dst, const double* a, size_t n)
+    {
+        const __m256d signMask = _mm256_set1_pd(-0.0);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, _mm256_andnot_pd(signMask, _mm256_loadu_pd(a + i)));
+        absValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void sqrtValuesAvx2(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, _mm256_sqrt_pd(_mm256_loadu_pd(a + i)));
+        sqrtValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void expValuesAvx2(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, expAvx2(_mm256_loadu_pd(a + i)));
+        expValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void logValuesAvx2(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, logAvx2(_mm256_loadu_pd(a + i)));
+        logValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void sigmoidValuesAvx2(double* dst, const double* a, size_t n)
+    {
+        const __m256d one = _mm256_set1_pd(1.0);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            const __m256d e = expAvx2(_mm256_sub_pd(_mm256_setzero_pd(), _mm256_loadu_pd(a + i)));
+            _mm256_storeu_pd(dst + i, _mm256_div_pd(one, _mm256_add_pd(one, e)));
+        }
+        sigmoidValuesScalar(dst + i, a + i, n - i);
+    }
+
+    KERNEL_TARGET("avx2") void clampValuesAvx2(double* dst, const double* a, double lower, double upper, size_t n)
+    {
+        const __m256d lo = _mm256_set1_pd(lower);
+        const __m256d hi = _mm256_set1_pd(upper);
+        size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+            _mm256_storeu_pd(dst + i, _mm256_min_pd(hi, _mm256_max_pd(lo, _mm256_loadu_pd(a + i))));
+        clampValuesScalar(dst + i, a + i, lower, upper, n - i);
+    }
+
+    // AVX2 has gathers but no scatters, scatterAxpy stays scalar
+
+    KERNEL_TARGET("avx2") double gatherDotAvx2(const double* values, const size_t* indices, const double* dense, size_t nnz)
+    {
+        __m256d s0 = _mm256_setzero_pd(), s1 = _mm256_setzero_pd();
+        size_t k = 0;
+        for (; k + 8 <= nnz; k += 8)
+        {
+            const __m256i i0 = _mm256_loadu_si256((const __m256i*)(indices + k));
+            const __m256i i1 = _mm256_loadu_si256((const __m256i*)(indices + k + 4));
+            s0 = _mm256_add_pd(s0, _mm256_mul_pd(_mm256_loadu_pd(values + k), _mm256_i64gather_pd(dense, i0, 8)));
+            s1 = _mm256_add_pd(s1, _mm256_mul_pd(_mm256_loadu_pd(values + k + 4), _mm256_i64gather_pd(dense, i1, 8)));
+        }
+        return hsumAvx2(_mm256_add_pd(s0, s1)) + gatherDotScalar(values + k, indices + k, dense, nnz - k);
+    }
+
+    KERNEL_TARGET("avx2") bool scatterAxpyIsFiniteAvx2(const double* dense, const size_t* indices, const double* values,
+                                                       double c, size_t nnz)
+    {
+        const __m256d mul = _mm256_set1_pd(c);
+        __m256d bad = _mm256_setzero_pd();
+        size_t k = 0;
+        for (; k + 4 <= nnz; k += 4)
+        {
+            const __m256d d = _mm256_i64gather_pd(dense, _mm256_loadu_si256((const __m256i*)(indices + k)), 8);
+            const __m256d r = _mm256_add_pd(d, _mm256_mul_pd(mul, _mm256_loadu_pd(values + k)));
+            bad = _mm256_or_pd(bad, _mm256_sub_pd(r, r));
+        }
+        return allZeroAvx2(bad) && scatterAxpyIsFiniteScalar(dense, indices + k, values + k, c, nnz - k);
+    }
+
+    ///////////////////AVX-512/////////////////
+
+    // Tails are processed with masked loads and stores, masked-off lanes read as zeros
+
+    KERNEL_TARGET("avx512f") inline __mmask8 tailMask(size_t rest)
+    {
+        return (__mmask8)((1u << rest) - 1);
+    }
+
+    KERNEL_TARGET("avx512f") void combineAvx512(double* dst, const double* a, const double* b, double sign, size_t n)
+    {
+        const __m512d s = _mm512_set1_pd(sign);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_mul_pd(s, _mm512_loadu_pd(b + i))));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d r = _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_mul_pd(s, _mm512_maskz_loadu_pd(m, b + i)));
+            _mm512_mask_storeu_pd(dst + i, m, r);
+        }
+    }
+
+    KERNEL_TARGET("avx512f") bool combineIsFiniteAvx512(const double* a, const double* b, double sign, size_t n)
+    {
+        const __m512d s = _mm512_set1_pd(sign);
+        __m512d bad = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d r = _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_mul_pd(s, _mm512_loadu_pd(b + i)));
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d r = _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_mul_pd(s, _mm512_maskz_loadu_pd(m, b + i)));
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        return _mm512_cmp_pd_mask(bad, _mm512_setzero_pd(), _CMP_EQ_OQ) == 0xFF;
+    }
+
+    KERNEL_TARGET("avx512f") bool combineCheckedAvx512(double* dst, const double* a, const double* b, double sign, size_t n)
+    {
+        const __m512d s = _mm512_set1_pd(sign);
+        __m512d bad = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d r = _mm512_add_pd(_mm512_loadu_pd(a + i), _mm512_mul_pd(s, _mm512_loadu_pd(b + i)));
+            _mm512_storeu_pd(dst + i, r);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d r = _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_mul_pd(s, _mm512_maskz_loadu_pd(m, b + i)));
+            _mm512_mask_storeu_pd(dst + i, m, r);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        return _mm512_cmp_pd_mask(bad, _mm512_setzero_pd(), _CMP_EQ_OQ) == 0xFF;
+    }
+
+    KERNEL_TARGET("avx512f") inline __m512d linearAtAvx512(const double* coefs, const double* const* srcs, size_t count,
+                                                           size_t i, __mmask8 m)
+    {
+        __m512d acc = _mm512_setzero_pd();
+        for (size_t t = 0; t < count; ++t)
+            acc = _mm512_add_pd(acc, _mm512_mul_pd(_mm512_set1_pd(coefs[t]), _mm512_maskz_loadu_pd(m, srcs[t] + i)));
+        return acc;
+    }
+
+    KERNEL_TARGET("avx512f") void linearAvx512(double* dst, const double* coefs, const double* const* srcs, size_t count,
+                                               size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, linearAtAvx512(coefs, srcs, count, i, 0xFF));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, linearAtAvx512(coefs, srcs, count, i, m));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") bool linearIsFiniteAvx512(const double* coefs, const double* const* srcs, size_t count,
+                                                       size_t n)
+    {
+        __m512d bad = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d r = linearAtAvx512(coefs, srcs, count, i, 0xFF);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        if (i < n)
+        {
+            const __m512d r = linearAtAvx512(coefs, srcs, count, i, tailMask(n - i));
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        return _mm512_cmp_pd_mask(bad, _mm512_setzero_pd(), _CMP_EQ_OQ) == 0xFF;
+    }
+
+    KERNEL_TARGET("avx512f") bool linearCheckedAvx512(double* dst, const double* coefs, const double* const* srcs,
+                                                      size_t count, size_t n)
+    {
+        __m512d bad = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d r = linearAtAvx512(coefs, srcs, count, i, 0xFF);
+            _mm512_storeu_pd(dst + i, r);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d r = linearAtAvx512(coefs, srcs, count, i, m);
+            _mm512_mask_storeu_pd(dst + i, m, r);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        return _mm512_cmp_pd_mask(bad, _mm512_setzero_pd(), _CMP_EQ_OQ) == 0xFF;
+    }
+
+    KERNEL_TARGET("avx512f") void scaleAvx512(double* dst, const double* a, double multiplier, size_t n)
+    {
+        const __m512d mul = _mm512_set1_pd(multiplier);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, _mm512_mul_pd(_mm512_loadu_pd(a + i), mul));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, a + i), mul));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") bool scaleIsFiniteAvx512(const double* a, double multiplier, size_t n)
+    {
+        const __m512d mul = _mm512_set1_pd(multiplier);
+        __m512d bad = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d r = _mm512_mul_pd(_mm512_loadu_pd(a + i), mul);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        if (i < n)
+        {
+            const __m512d r = _mm512_mul_pd(_mm512_maskz_loadu_pd(tailMask(n - i), a + i), mul);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        return _mm512_cmp_pd_mask(bad, _mm512_setzero_pd(), _CMP_EQ_OQ) == 0xFF;
+    }
+
+    KERNEL_TARGET("avx512f") void shiftAvx512(double* dst, const double* a, double c, size_t n)
+    {
+        const __m512d s = _mm512_set1_pd(c);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, _mm512_add_pd(_mm512_loadu_pd(a + i), s));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), s));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") bool shiftIsFiniteAvx512(const double* a, double c, size_t n)
+    {
+        const __m512d s = _mm512_set1_pd(c);
+        __m512d bad = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d r = _mm512_add_pd(_mm512_loadu_pd(a + i), s);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d r = _mm512_add_pd(_mm512_maskz_loadu_pd(m, a + i), s);
+            bad = _mm512_mask_add_pd(bad, m, bad, _mm512_sub_pd(r, r));
+        }
+        return _mm512_cmp_pd_mask(bad, _mm512_setzero_pd(), _CMP_EQ_OQ) == 0xFF;
+    }
+
+    KERNEL_TARGET("avx512f") bool isFiniteAvx512(const double* a, size_t n)
+    {
+        __m512d bad = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d r = _mm512_loadu_pd(a + i);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        if (i < n)
+        {
+            const __m512d r = _mm512_maskz_loadu_pd(tailMask(n - i), a + i);
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        return _mm512_cmp_pd_mask(bad, _mm512_setzero_pd(), _CMP_EQ_OQ) == 0xFF;
+    }
+
+    KERNEL_TARGET("avx512f") double dotAvx512(const double* a, const double* b, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8)));
+            s2 = _mm512_add_pd(s2, _mm512_mul_pd(_mm512_loadu_pd(a + i + 16), _mm512_loadu_pd(b + i + 16)));
+            s3 = _mm512_add_pd(s3, _mm512_mul_pd(_mm512_loadu_pd(a + i + 24), _mm512_loadu_pd(b + i + 24)));
+        }
+        for (; i + 8 <= n; i += 8)
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+        }
+        return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+    }
+
+    KERNEL_TARGET("avx512f") double sumAbsAvx512(const double* a, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd(), s2 = _mm512_setzero_pd(), s3 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 32 <= n; i += 32)
+        {
+            s0 = _mm512_add_pd(s0, _mm512_abs_pd(_mm512_loadu_pd(a + i)));
+            s1 = _mm512_add_pd(s1, _mm512_abs_pd(_mm512_loadu_pd(a + i + 8)));
+            s2 = _mm512_add_pd(s2, _mm512_abs_pd(_mm512_loadu_pd(a + i + 16)));
+            s3 = _mm512_add_pd(s3, _mm512_abs_pd(_mm512_loadu_pd(a + i + 24)));
+        }
+        for (; i + 8 <= n; i += 8)
+            s0 = _mm512_add_pd(s0, _mm512_abs_pd(_mm512_loadu_pd(a + i)));
+        if (i < n)
+            s1 = _mm512_add_pd(s1, _mm512_abs_pd(_mm512_maskz_loadu_pd(tailMask(n - i), a + i)));
+        return _mm512_reduce_add_pd(_mm512_add_pd(_mm512_add_pd(s0, s1), _mm512_add_pd(s2, s3)));
+    }
+
+    KERNEL_TARGET("avx512f") double sumSquaresAvx512(const double* a, size_t n)
+    {
+        return dotAvx512(a, a, n);
+    }
+
+    KERNEL_TARGET("avx512f") double maxAbsAvx512(const double* a, size_t n)
+    {
+        __m512d m0 = _mm512_setzero_pd(), m1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            m0 = _mm512_max_pd(m0, _mm512_abs_pd(_mm512_loadu_pd(a + i)));
+            m1 = _mm512_max_pd(m1, _mm512_abs_pd(_mm512_loadu_pd(a + i + 8)));
+        }
+        for (; i + 8 <= n; i += 8)
+            m0 = _mm512_max_pd(m0, _mm512_abs_pd(_mm512_loadu_pd(a + i)));
+        if (i < n)
+            m1 = _mm512_max_pd(m1, _mm512_abs_pd(_mm512_maskz_loadu_pd(tailMask(n - i), a + i)));
+        return _mm512_reduce_max_pd(_mm512_max_pd(m0, m1));
+    }
+
+    KERNEL_TARGET("avx512f") double sumAbsDiffAvx512(const double* a, const double* b, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm512_add_pd(s0, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i))));
+            s1 = _mm512_add_pd(s1, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8))));
+        }
+        for (; i + 8 <= n; i += 8)
+            s0 = _mm512_add_pd(s0, _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i))));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            s1 = _mm512_add_pd(s1, _mm512_abs_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i))));
+        }
+        return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    }
+
+    KERNEL_TARGET("avx512f") double sumSquaresDiffAvx512(const double* a, const double* b, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512d d0 = _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+            const __m512d d1 = _mm512_sub_pd(_mm512_loadu_pd(a + i + 8), _mm512_loadu_pd(b + i + 8));
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(d0, d0));
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(d1, d1));
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d d = _mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i));
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(d, d));
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d d = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i));
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(d, d));
+        }
+        return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    }
+
+    KERNEL_TARGET("avx512f") double maxAbsDiffAvx512(const double* a, const double* b, size_t n)
+    {
+        __m512d m0 = _mm512_setzero_pd();
+        __mmask8 bad = 0;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d d = _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(a + i), _mm512_loadu_pd(b + i)));
+            m0 = _mm512_max_pd(m0, d);
+            bad |= _mm512_cmp_pd_mask(d, d, _CMP_UNORD_Q);
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d d = _mm512_abs_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, a + i), _mm512_maskz_loadu_pd(m, b + i)));
+            m0 = _mm512_max_pd(m0, d);
+            bad |= _mm512_cmp_pd_mask(d, d, _CMP_UNORD_Q);
+        }
+        return bad != 0 ? std::nan("") : _mm512_reduce_max_pd(m0);
+    }
+
+    KERNEL_TARGET("avx512f") void columnSumAbsDiffAvx512(double* acc, const double* col, double c, size_t n)
+    {
+        const __m512d cv = _mm512_set1_pd(c);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d d = _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(col + i), cv));
+            _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), d));
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d d = _mm512_abs_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, col + i), cv));
+            _mm512_mask_storeu_pd(acc + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, acc + i), d));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") void columnSumSquaresDiffAvx512(double* acc, const double* col, double c, size_t n)
+    {
+        const __m512d cv = _mm512_set1_pd(c);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d d = _mm512_sub_pd(_mm512_loadu_pd(col + i), cv);
+            _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), _mm512_mul_pd(d, d)));
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d d = _mm512_sub_pd(_mm512_maskz_loadu_pd(m, col + i), cv);
+            _mm512_mask_storeu_pd(acc + i, m, _mm512_add_pd(_mm512_maskz_loadu_pd(m, acc + i), _mm512_mul_pd(d, d)));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") void columnMaxAbsDiffAvx512(double* acc, const double* col, double c, size_t n)
+    {
+        const __m512d cv = _mm512_set1_pd(c);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d d = _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(col + i), cv));
+            _mm512_storeu_pd(acc + i, _mm512_max_pd(_mm512_loadu_pd(acc + i), d));
+        }
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d d = _mm512_abs_pd(_mm512_sub_pd(_mm512_maskz_loadu_pd(m, col + i), cv));
+            _mm512_mask_storeu_pd(acc + i, m, _mm512_max_pd(_mm512_maskz_loadu_pd(m, acc + i), d));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") void columnAxpyAvx512(double* acc, const double* col, double c, size_t n)
+    {
+        const __m512d cv = _mm512_set1_pd(c);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(acc + i, _mm512_add_pd(_mm512_loadu_pd(acc + i), _mm512_mul_pd(cv, _mm512_loadu_pd(col + i))));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            const __m512d r = _mm512_add_pd(_mm512_maskz_loadu_pd(m, acc + i), _mm512_mul_pd(cv, _mm512_maskz_loadu_pd(m, col + i)));
+            _mm512_mask_storeu_pd(acc + i, m, r);
+        }
+    }
+
+    // Eight floats are widened to one register of doubles, tails are loaded with a mask of float lanes
+
+    KERNEL_TARGET("avx512f") inline __m512d loadFloatsAvx512(const float* p)
+    {
+        return _mm512_cvtps_pd(_mm256_loadu_ps(p));
+    }
+
+    KERNEL_TARGET("avx512f") inline __m512d loadFloatsAvx512(const float* p, size_t rest)
+    {
+        const __m512 v = _mm512_maskz_loadu_ps((__mmask16)((1u << rest) - 1), p);
+        return _mm512_cvtps_pd(_mm512_castps512_ps256(v));
+    }
+
+    KERNEL_TARGET("avx512f") double dotFloatAvx512(const float* a, const float* b, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(loadFloatsAvx512(a + i), loadFloatsAvx512(b + i)));
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(loadFloatsAvx512(a + i + 8), loadFloatsAvx512(b + i + 8)));
+        }
+        for (; i + 8 <= n; i += 8)
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(loadFloatsAvx512(a + i), loadFloatsAvx512(b + i)));
+        if (i < n)
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(loadFloatsAvx512(a + i, n - i), loadFloatsAvx512(b + i, n - i)));
+        return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    }
+
+    KERNEL_TARGET("avx512f") double dotMixedAvx512(const float* a, const double* b, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(loadFloatsAvx512(a + i), _mm512_loadu_pd(b + i)));
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(loadFloatsAvx512(a + i + 8), _mm512_loadu_pd(b + i + 8)));
+        }
+        for (; i + 8 <= n; i += 8)
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(loadFloatsAvx512(a + i), _mm512_loadu_pd(b + i)));
+        if (i < n)
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(loadFloatsAvx512(a + i, n - i), _mm512_maskz_loadu_pd(tailMask(n - i), b + i)));
+        return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    }
+
+    KERNEL_TARGET("avx512f") double sumAbsFloatAvx512(const float* a, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm512_add_pd(s0, _mm512_abs_pd(loadFloatsAvx512(a + i)));
+            s1 = _mm512_add_pd(s1, _mm512_abs_pd(loadFloatsAvx512(a + i + 8)));
+        }
+        for (; i + 8 <= n; i += 8)
+            s0 = _mm512_add_pd(s0, _mm512_abs_pd(loadFloatsAvx512(a + i)));
+        if (i < n)
+            s1 = _mm512_add_pd(s1, _mm512_abs_pd(loadFloatsAvx512(a + i, n - i)));
+        return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    }
+
+    KERNEL_TARGET("avx512f") double sumSquaresFloatAvx512(const float* a, size_t n)
+    {
+        return dotFloatAvx512(a, a, n);
+    }
+
+    KERNEL_TARGET("avx512f") double maxAbsFloatAvx512(const float* a, size_t n)
+    {
+        __m512d m0 = _mm512_setzero_pd(), m1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            m0 = _mm512_max_pd(m0, _mm512_abs_pd(loadFloatsAvx512(a + i)));
+            m1 = _mm512_max_pd(m1, _mm512_abs_pd(loadFloatsAvx512(a + i + 8)));
+        }
+        for (; i + 8 <= n; i += 8)
+            m0 = _mm512_max_pd(m0, _mm512_abs_pd(loadFloatsAvx512(a + i)));
+        if (i < n)
+            m1 = _mm512_max_pd(m1, _mm512_abs_pd(loadFloatsAvx512(a + i, n - i)));
+        return _mm512_reduce_max_pd(_mm512_max_pd(m0, m1));
+    }
+
+    KERNEL_TARGET("avx512f") double sumAbsDiffFloatAvx512(const float* a, const float* b, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            s0 = _mm512_add_pd(s0, _mm512_abs_pd(_mm512_sub_pd(loadFloatsAvx512(a + i), loadFloatsAvx512(b + i))));
+            s1 = _mm512_add_pd(s1, _mm512_abs_pd(_mm512_sub_pd(loadFloatsAvx512(a + i + 8), loadFloatsAvx512(b + i + 8))));
+        }
+        for (; i + 8 <= n; i += 8)
+            s0 = _mm512_add_pd(s0, _mm512_abs_pd(_mm512_sub_pd(loadFloatsAvx512(a + i), loadFloatsAvx512(b + i))));
+        if (i < n)
+            s1 = _mm512_add_pd(s1, _mm512_abs_pd(_mm512_sub_pd(loadFloatsAvx512(a + i, n - i), loadFloatsAvx512(b + i, n - i))));
+        return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    }
+
+    KERNEL_TARGET("avx512f") double sumSquaresDiffFloatAvx512(const float* a, const float* b, size_t n)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t i = 0;
+        for (; i + 16 <= n; i += 16)
+        {
+            const __m512d d0 = _mm512_sub_pd(loadFloatsAvx512(a + i), loadFloatsAvx512(b + i));
+            const __m512d d1 = _mm512_sub_pd(loadFloatsAvx512(a + i + 8), loadFloatsAvx512(b + i + 8));
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(d0, d0));
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(d1, d1));
+        }
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d d = _mm512_sub_pd(loadFloatsAvx512(a + i), loadFloatsAvx512(b + i));
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(d, d));
+        }
+        if (i < n)
+        {
+            const __m512d d = _mm512_sub_pd(loadFloatsAvx512(a + i, n - i), loadFloatsAvx512(b + i, n - i));
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(d, d));
+        }
+        return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    }
+
+    KERNEL_TARGET("avx512f") double maxAbsDiffFloatAvx512(const float* a, const float* b, size_t n)
+    {
+        __m512d m0 = _mm512_setzero_pd();
+        __mmask8 bad = 0;
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+        {
+            const __m512d d = _mm512_abs_pd(_mm512_sub_pd(loadFloatsAvx512(a + i), loadFloatsAvx512(b + i)));
+            m0 = _mm512_max_pd(m0, d);
+            bad |= _mm512_cmp_pd_mask(d, d, _CMP_UNORD_Q);
+        }
+        if (i < n)
+        {
+            const __m512d d = _mm512_abs_pd(_mm512_sub_pd(loadFloatsAvx512(a + i, n - i), loadFloatsAvx512(b + i, n - i)));
+            m0 = _mm512_max_pd(m0, d);
+            bad |= _mm512_cmp_pd_mask(d, d, _CMP_UNORD_Q);
+        }
+        return bad != 0 ? std::nan("") : _mm512_reduce_max_pd(m0);
+    }
+
+    KERNEL_TARGET("avx512f") inline __m512d pow2Avx512(__m512d k)
+    {
+        return _mm512_castsi512_pd(_mm512_slli_epi64(_mm512_castpd_si512(_mm512_add_pd(k, _mm512_set1_pd(exponentMagic))), 52));
+    }
+
+    KERNEL_TARGET("avx512f") inline __m512d expAvx512(__m512d x)
+    {
+        const __m512d magic = _mm512_set1_pd(roundMagic);
+        x = _mm512_min_pd(_mm512_set1_pd(expMax), _mm512_max_pd(_mm512_set1_pd(expMin), x));
+
+        const __m512d k = _mm512_sub_pd(_mm512_add_pd(_mm512_mul_pd(x, _mm512_set1_pd(log2e)), magic), magic);
+        const __m512d r = _mm512_sub_pd(_mm512_sub_pd(x, _mm512_mul_pd(k, _mm512_set1_pd(ln2Hi))),
+                                        _mm512_mul_pd(k, _mm512_set1_pd(ln2Lo)));
+
+        __m512d p = _mm512_set1_pd(expCoefs[0]);
+        for (size_t c = 1; c < expTerms; ++c)
+            p = _mm512_add_pd(_mm512_mul_pd(p, r), _mm512_set1_pd(expCoefs[c]));
+
+        const __m512d k1 = _mm512_sub_pd(_mm512_add_pd(_mm512_mul_pd(k, _mm512_set1_pd(0.5)), magic), magic);
+        return _mm512_mul_pd(_mm512_mul_pd(p, pow2Avx512(k1)), pow2Avx512(_mm512_sub_pd(k, k1)));
+    }
+
+    KERNEL_TARGET("avx512f") inline __m512d logAvx512(__m512d x)
+    {
+        const __m512d one = _mm512_set1_pd(1.0);
+        const __mmask8 tiny = _mm512_cmp_pd_mask(x, _mm512_set1_pd(DBL_MIN), _CMP_LT_OQ);
+        const __m512d y = _mm512_mask_mul_pd(x, tiny, x, _mm512_set1_pd(subnormalScale));
+        const __m512i bits = _mm512_castpd_si512(y);
+
+        __m512d e = _mm512_maskz_mov_pd(tiny, _mm512_set1_pd(-52.0));
+        const __m512i exponent = _mm512_or_si512(_mm512_srli_epi64(bits, 52), _mm512_set1_epi64((long long)twoPow52Bits));
+        e = _mm512_add_pd(e, _mm512_sub_pd(_mm512_castsi512_pd(exponent), _mm512_set1_pd(exponentBias)));
+
+        __m512d m = _mm512_castsi512_pd(_mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi64((long long)mantissaMask)),
+                                                        _mm512_set1_epi64((long long)oneBits)));
+        const __mmask8 big = _mm512_cmp_pd_mask(m, _mm512_set1_pd(sqrt2), _CMP_GT_OQ);
+        m = _mm512_mask_mul_pd(m, big, m, _mm512_set1_pd(0.5));
+        e = _mm512_mask_add_pd(e, big, e, one);
+
+        const __m512d f = _mm512_sub_pd(m, one);
+        const __m512d s = _mm512_div_pd(f, _mm512_add_pd(_mm512_set1_pd(2.0), f));
+        const __m512d z = _mm512_mul_pd(s, s);
+        __m512d p = _mm512_set1_pd(logCoefs[0]);
+        for (size_t c = 1; c < logTerms; ++c)
+            p = _mm512_add_pd(_mm512_mul_pd(p, z), _mm512_set1_pd(logCoefs[c]));
+
+        const __m512d hfsq = _mm512_mul_pd(_mm512_mul_pd(_mm512_set1_pd(0.5), f), f);
+        const __m512d tail = _mm512_add_pd(_mm512_mul_pd(s, _mm512_add_pd(hfsq, _mm512_mul_pd(z, p))),
+                                           _mm512_mul_pd(e, _mm512_set1_pd(ln2Lo)));
+        __m512d result = _mm512_sub_pd(_mm512_mul_pd(e, _mm512_set1_pd(ln2Hi)),
+                                       _mm512_sub_pd(_mm512_sub_pd(hfsq, tail), f));
+
+        const __m512d inf = _mm512_set1_pd(HUGE_VAL);
+        result = _mm512_mask_mov_pd(result, _mm512_cmp_pd_mask(x, inf, _CMP_EQ_OQ), inf);
+        result = _mm512_mask_mov_pd(result, _mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_EQ_OQ), _mm512_set1_pd(-HUGE_VAL));
+        return _mm512_mask_mov_pd(result, _mm512_cmp_pd_mask(x, _mm512_setzero_pd(), _CMP_NGE_UQ), _mm512_set1_pd(std::nan("")));
+    }
+
+    KERNEL_TARGET("avx512f") void absValuesAvx512(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, _mm512_abs_pd(_mm512_loadu_pd(a + i)));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, _mm512_abs_pd(_mm512_maskz_loadu_pd(m, a + i)));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") void sqrtValuesAvx512(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, _mm512_sqrt_pd(_mm512_loadu_pd(a + i)));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, _mm512_sqrt_pd(_mm512_maskz_loadu_pd(m, a + i)));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") void expValuesAvx512(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, expAvx512(_mm512_loadu_pd(a + i)));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, expAvx512(_mm512_maskz_loadu_pd(m, a + i)));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") void logValuesAvx512(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, logAvx512(_mm512_loadu_pd(a + i)));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, logAvx512(_mm512_maskz_loadu_pd(m, a + i)));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") inline __m512d sigmoidAvx512(__m512d x)
+    {
+        const __m512d one = _mm512_set1_pd(1.0);
+        return _mm512_div_pd(one, _mm512_add_pd(one, expAvx512(_mm512_sub_pd(_mm512_setzero_pd(), x))));
+    }
+
+    KERNEL_TARGET("avx512f") void sigmoidValuesAvx512(double* dst, const double* a, size_t n)
+    {
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, sigmoidAvx512(_mm512_loadu_pd(a + i)));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, sigmoidAvx512(_mm512_maskz_loadu_pd(m, a + i)));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") void clampValuesAvx512(double* dst, const double* a, double lower, double upper, size_t n)
+    {
+        const __m512d lo = _mm512_set1_pd(lower);
+        const __m512d hi = _mm512_set1_pd(upper);
+        size_t i = 0;
+        for (; i + 8 <= n; i += 8)
+            _mm512_storeu_pd(dst + i, _mm512_min_pd(hi, _mm512_max_pd(lo, _mm512_loadu_pd(a + i))));
+        if (i < n)
+        {
+            const __mmask8 m = tailMask(n - i);
+            _mm512_mask_storeu_pd(dst + i, m, _mm512_min_pd(hi, _mm512_max_pd(lo, _mm512_maskz_loadu_pd(m, a + i))));
+        }
+    }
+
+    KERNEL_TARGET("avx512f") double gatherDotAvx512(const double* values, const size_t* indices, const double* dense, size_t nnz)
+    {
+        __m512d s0 = _mm512_setzero_pd(), s1 = _mm512_setzero_pd();
+        size_t k = 0;
+        for (; k + 16 <= nnz; k += 16)
+        {
+            const __m512i i0 = _mm512_loadu_si512(indices + k);
+            const __m512i i1 = _mm512_loadu_si512(indices + k + 8);
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(_mm512_loadu_pd(values + k), _mm512_i64gather_pd(i0, dense, 8)));
+            s1 = _mm512_add_pd(s1, _mm512_mul_pd(_mm512_loadu_pd(values + k + 8), _mm512_i64gather_pd(i1, dense, 8)));
+        }
+        for (; k < nnz; k += 8)
+        {
+            const __mmask8 m = nnz - k >= 8 ? (__mmask8)0xFF : tailMask(nnz - k);
+            const __m512i idx = _mm512_maskz_loadu_epi64(m, indices + k);
+            const __m512d d = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), m, idx, dense, 8);
+            s0 = _mm512_add_pd(s0, _mm512_mul_pd(_mm512_maskz_loadu_pd(m, values + k), d));
+        }
+        return _mm512_reduce_add_pd(_mm512_add_pd(s0, s1));
+    }
+
+    // Indices of a sparse vector are distinct, so the lanes of one scatter never collide
+    KERNEL_TARGET("avx512f") void scatterAxpyAvx512(double* dense, const size_t* indices, const double* values, double c, size_t nnz)
+    {
+        const __m512d mul = _mm512_set1_pd(c);
+        for (size_t k = 0; k < nnz; k += 8)
+        {
+            const __mmask8 m = nnz - k >= 8 ? (__mmask8)0xFF : tailMask(nnz - k);
+            const __m512i idx = _mm512_maskz_loadu_epi64(m, indices + k);
+            const __m512d d = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), m, idx, dense, 8);
+            const __m512d r = _mm512_add_pd(d, _mm512_mul_pd(mul, _mm512_maskz_loadu_pd(m, values + k)));
+            _mm512_mask_i64scatter_pd(dense, m, idx, r, 8);
+        }
+    }
+
+    KERNEL_TARGET("avx512f") bool scatterAxpyIsFiniteAvx512(const double* dense, const size_t* indices, const double* values,
+                                                            double c, size_t nnz)
+    {
+        const __m512d mul = _mm512_set1_pd(c);
+        __m512d bad = _mm512_setzero_pd();
+        for (size_t k = 0; k < nnz; k += 8)
+        {
+            const __mmask8 m = nnz - k >= 8 ? (__mmask8)0xFF : tailMask(nnz - k);
+            const __m512i idx = _mm512_maskz_loadu_epi64(m, indices + k);
+            const __m512d d = _mm512_mask_i64gather_pd(_mm512_setzero_pd(), m, idx, dense, 8);
+            const __m512d r = _mm512_add_pd(d, _mm512_mul_pd(mul, _mm512_maskz_loadu_pd(m, values + k)));
+            bad = _mm512_add_pd(bad, _mm512_sub_pd(r, r));
+        }
+        return _mm512_cmp_pd_mask(bad, _mm512_setzero_pd(), _CMP_EQ_OQ) == 0xFF;
+    }
+
+#endif
+
+    const VectorKernels::Table scalarTable = {
+        VectorKernels::ISA::SCALAR,
+        combineScalar, combineIsFiniteScalar, combineCheckedScalar,
+        linearScalar, linearIsFiniteScalar, linearCheckedScalar,
+        scaleScalar, scaleIsFiniteScalar,
+        shiftScalar, shiftIsFiniteScalar,
+        isFiniteScalar,
+        dotScalar, sumAbsScalar, sumSquaresScalar, maxAbsScalar,
+        sumAbsDiffScalar, sumSquaresDiffScalar, maxAbsDiffScalar,
+        columnSumAbsDiffScalar, columnSumSquaresDiffScalar, columnMaxAbsDiffScalar, columnAxpyScalar,
+        dotFloatScalar, dotMixedScalar, sumAbsFloatScalar, sumSquaresFloatScalar, maxAbsFloatScalar,
+        sumAbsDiffFloatScalar, sumSquaresDiffFloatScalar, maxAbsDiffFloatScalar,
+        absValuesScalar, sqrtValuesScalar, expValuesScalar, logValuesScalar, sigmoidValuesScalar, clampValuesScalar,
+        gatherDotScalar, scatterAxpyScalar, scatterAxpyIsFiniteScalar
+    };
+
+#ifdef VECTOR_KERNELS_X86
+    const VectorKernels::Table sse2Table = {
+        VectorKernels::ISA::SSE2,
+        combineSse2, combineIsFiniteSse2, combineCheckedSse2,
+        linearSse2, linearIsFiniteSse2, linearCheckedSse2,
+        scaleSse2, scaleIsFiniteSse2,
+        shiftSse2, shiftIsFiniteSse2,
+        isFiniteSse2,
+        dotSse2, sumAbsSse2, sumSquaresSse2, maxAbsSse2,
+        sumAbsDiffSse2, sumSquaresDiffSse2, maxAbsDiffSse2,
+        columnSumAbsDiffSse2, columnSumSquaresDiffSse2, columnMaxAbsDiffSse2, columnAxpySse2,
+        dotFloatSse2, dotMixedSse2, sumAbsFloatSse2, sumSquaresFloatSse2, maxAbsFloatSse2,
+        sumAbsDiffFloatSse2, sumSquaresDiffFloatSse2, maxAbsDiffFloatSse2,
+        absValuesSse2, sqrtValuesSse2, expValuesSse2, logValuesSse2, sigmoidValuesSse2, clampValuesSse2,
+        gatherDotScalar, scatterAxpyScalar, scatterAxpyIsFiniteScalar
+    };
+
+    const VectorKernels::Table avx2Table = {
+        VectorKernels::ISA::AVX2,
+        combineAvx2, combineIsFiniteAvx2, combineCheckedAvx2,
+        linearAvx2, linearIsFiniteAvx2, linearCheckedAvx2,
+        scaleAvx2, scaleIsFiniteAvx2,
+        shiftAvx2, shiftIsFiniteAvx2,
+        isFiniteAvx2,
+        dotAvx2, sumAbsAvx2, sumSquaresAvx2, maxAbsAvx2,
+        sumAbsDiffAvx2, sumSquaresDiffAvx2, maxAbsDiffAvx2,
+        columnSumAbsDiffAvx2, columnSumSquaresDiffAvx2, columnMaxAbsDiffAvx2, columnAxpyAvx2,
+        dotFloatAvx2, dotMixedAvx2, sumAbsFloatAvx2, sumSquaresFloatAvx2, maxAbsFloatAvx2,
+        sumAbsDiffFloatAvx2, sumSquaresDiffFloatAvx2, maxAbsDiffFloatAvx2,
+        absValuesAvx2, sqrtValuesAvx2, expValuesAvx2, logValuesAvx2, sigmoidValuesAvx2, clampValuesAvx2,
+        gatherDotAvx2, scatterAxpyScalar, scatterAxpyIsFiniteAvx2
+    };
+
+    const VectorKernels::Table avx512Table = {
+        VectorKernels::ISA::AVX512,
+        combineAvx512, combineIsFiniteAvx512, combineCheckedAvx512,
+        linearAvx512, linearIsFiniteAvx512, linearCheckedAvx512,
+        scaleAvx512, scaleIsFiniteAvx512,
+        shiftAvx512, shiftIsFiniteAvx512,
+        isFiniteAvx512,
+        dotAvx512, sumAbsAvx512, sumSquaresAvx512, maxAbsAvx512,
+        sumAbsDiffAvx512, sumSquaresDiffAvx512, maxAbsDiffAvx512,
+        columnSumAbsDiffAvx512, columnSumSquaresDiffAvx512, columnMaxAbsDiffAvx512, columnAxpyAvx512,
+        dotFloatAvx512, dotMixedAvx512, sumAbsFloatAvx512, sumSquaresFloatAvx512, maxAbsFloatAvx512,
+        sumAbsDiffFloatAvx512, sumSquaresDiffFloatAvx512, maxAbsDiffFloatAvx512,
+        absValuesAvx512, sqrtValuesAvx512, expValuesAvx512, logValuesAvx512, sigmoidValuesAvx512, clampValuesAvx512,
+        gatherDotAvx512, scatterAxpyAvx512, scatterAxpyIsFiniteAvx512
+    };
+#endif
+}
+
+const VectorKernels::Table& VectorKernels::get(ISA isa)
+{
+#ifdef VECTOR_KERNELS_X86
+    __builtin_cpu_init();
+
+    if (isa >= ISA::AVX512 && __builtin_cpu_supports("avx512f"))
+        return avx512Table;
+
+    if (isa >= ISA::AVX2 && __builtin_cpu_supports("avx2"))
+        return avx2Table;
+
+    if (isa >= ISA::SSE2 && __builtin_cpu_supports("sse2"))
+        return sse2Table;
+#endif
+
+    return scalarTable;
+}
+
+const VectorKernels::Table& VectorKernels::get()
+{
+    static const Table& best = get(ISA::AVX512);
+    return best;
+}
+
+const char* VectorKernels::isaName(ISA isa)
+{
+    switch (isa)
+    {
+        case ISA::AVX512:
+            return "AVX-512";
+        case ISA::AVX2:
+            return "AVX2";
+        case ISA::SSE2:
+            return "SSE2";
+        default:
+            return "scalar";
+    }
+}
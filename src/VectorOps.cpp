@@ -0,0 +1,368 @@
+#include <cfenv>
+#include <cmath>
+#include <cstring>
+#include <new>
+#include "../myHeaders/VectorOps.h"
+#include "../myHeaders/VectorKernels.h"
+
+namespace
+{
+    const int overflowFlags = FE_OVERFLOW | FE_INVALID;
+
+    /*
+    * Per-thread buffer for the copy of the destination of DEFERRED_ROLLBACK policy and for the results of EAGER apply
+    */
+    class RollbackBuffer
+    {
+    public:
+        bool busy = false;
+
+        double* reserve(size_t n)
+        {
+            if (n > capacity)
+            {
+                double* grown = new (std::nothrow) double[n];
+                if (grown == nullptr)
+                    return nullptr;
+
+                delete[] buffer;
+                buffer = grown;
+                capacity = n;
+            }
+            return buffer;
+        }
+
+        ~RollbackBuffer()
+        {
+            delete[] buffer;
+        }
+
+    private:
+        double* buffer = nullptr;
+        size_t capacity = 0;
+    };
+
+    thread_local IVector::OVERFLOW_CHECK overflowCheck = IVector::OVERFLOW_CHECK::EAGER;
+    thread_local bool deferredOverflow = false;
+    thread_local RollbackBuffer rollbackBuffer;
+    thread_local RollbackBuffer scratchBuffer;
+
+    /*
+    * Lends the per-thread buffer to one call at a time
+    *
+    * User functions may apply functions to other vectors, a nested call then gets a buffer of its own
+    */
+    class BufferLease
+    {
+    public:
+        BufferLease(RollbackBuffer& buffer, size_t n) : shared(buffer)
+        {
+            if (n == 0)
+                return;
+
+            if (!shared.busy)
+            {
+                data = shared.reserve(n);
+                lent = data != nullptr;
+                shared.busy = lent;
+            }
+            else
+            {
+                owned = new (std::nothrow) double[n];
+                data = owned;
+            }
+        }
+
+        ~BufferLease()
+        {
+            if (lent)
+                shared.busy = false;
+            delete[] owned;
+        }
+
+        double* data = nullptr;
+
+    private:
+        BufferLease(const BufferLease& lease) = delete;
+        BufferLease& operator=(const BufferLease& lease) = delete;
+
+        RollbackBuffer& shared;
+        bool lent = false;
+        double* owned = nullptr;
+    };
+
+    /*
+    * Runs pass and reports whether it has raised overflow or invalid operation flags
+    *
+    * Flags of the caller are saved around the pass, so they are neither lost nor polluted
+    */
+    template <class Pass>
+    bool passIsFinite(Pass pass)
+    {
+        fexcept_t saved;
+        fegetexceptflag(&saved, overflowFlags);
+        feclearexcept(overflowFlags);
+
+        pass();
+
+        const bool raised = fetestexcept(overflowFlags) != 0;
+        fesetexceptflag(&saved, overflowFlags);
+        return !raised;
+    }
+
+    /*
+    * Single unchecked pass over dst for deferred policies
+    *
+    * check is called after the pass and tells whether the result is finite
+    */
+    template <class Pass, class Check>
+    RC runDeferred(double* dst, size_t n, Pass pass, Check check)
+    {
+        const bool rollback = overflowCheck == IVector::OVERFLOW_CHECK::DEFERRED_ROLLBACK;
+        BufferLease lease(rollbackBuffer, rollback ? n : 0);
+        double* copy = lease.data;
+        if (rollback)
+        {
+            if (copy == nullptr)
+                return RC::ALLOCATION_ERROR;
+
+            memcpy(copy, dst, n * sizeof(double));
+        }
+
+        if (check(pass))
+            return RC::SUCCESS;
+
+        deferredOverflow = true;
+        if (copy != nullptr)
+            memcpy(dst, copy, n * sizeof(double));
+
+        return RC::INFINITY_OVERFLOW;
+    }
+
+    /*
+    * EAGER pass of user functions: fill writes the results to a scratch buffer, which is copied to dst only if it
+    * is finite, so every function is called once per coordinate
+    */
+    template <class Fill>
+    RC runEager(double* dst, size_t n, Fill fill)
+    {
+        if (n == 0)
+            return RC::SUCCESS;
+
+        BufferLease scratch(scratchBuffer, n);
+        if (scratch.data == nullptr)
+            return RC::ALLOCATION_ERROR;
+
+        fill(scratch.data);
+        if (!VectorKernels::get().isFinite(scratch.data, n))
+            return RC::INFINITY_OVERFLOW;
+
+        memcpy(dst, scratch.data, n * sizeof(double));
+        return RC::SUCCESS;
+    }
+}
+
+RC VectorOps::setOverflowCheck(IVector::OVERFLOW_CHECK check)
+{
+    if (check != IVector::OVERFLOW_CHECK::EAGER && check != IVector::OVERFLOW_CHECK::DEFERRED &&
+        check != IVector::OVERFLOW_CHECK::DEFERRED_ROLLBACK)
+        return RC::INVALID_ARGUMENT;
+
+    overflowCheck = check;
+    return RC::SUCCESS;
+}
+
+IVector::OVERFLOW_CHECK VectorOps::getOverflowCheck()
+{
+    return overflowCheck;
+}
+
+RC VectorOps::checkDeferredOverflow()
+{
+    const bool overflowed = deferredOverflow;
+    deferredOverflow = false;
+    return overflowed ? RC::INFINITY_OVERFLOW : RC::SUCCESS;
+}
+
+RC VectorOps::combine(double* dst, const double* src, double sign, size_t n)
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+
+    // In-place EAGER passes check the results before writing them in a second pass over the same, cached operands.
+    // That is cheaper than computing into a scratch buffer and copying it back, fresh destinations take one pass
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+    {
+        if (!kernels.combineIsFinite(dst, src, sign, n))
+            return RC::INFINITY_OVERFLOW;
+
+        kernels.combine(dst, dst, src, sign, n);
+        return RC::SUCCESS;
+    }
+
+    return runDeferred(dst, n, [&]() { kernels.combine(dst, dst, src, sign, n); },
+                       [](const auto& pass) { return passIsFinite(pass); });
+}
+
+RC VectorOps::combineInto(double* dst, const double* a, const double* b, double sign, size_t n)
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+        return kernels.combineChecked(dst, a, b, sign, n) ? RC::SUCCESS : RC::INFINITY_OVERFLOW;
+
+    // Destination is fresh, so there is nothing to roll back
+    if (passIsFinite([&]() { kernels.combine(dst, a, b, sign, n); }))
+        return RC::SUCCESS;
+
+    deferredOverflow = true;
+    return RC::INFINITY_OVERFLOW;
+}
+
+RC VectorOps::linear(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n)
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+    {
+        if (!kernels.linearIsFinite(coefs, srcs, count, n))
+            return RC::INFINITY_OVERFLOW;
+
+        kernels.linear(dst, coefs, srcs, count, n);
+        return RC::SUCCESS;
+    }
+
+    return runDeferred(dst, n, [&]() { kernels.linear(dst, coefs, srcs, count, n); },
+                       [](const auto& pass) { return passIsFinite(pass); });
+}
+
+RC VectorOps::linearInto(double* dst, const double* coefs, const double* const* srcs, size_t count, size_t n)
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+        return kernels.linearChecked(dst, coefs, srcs, count, n) ? RC::SUCCESS : RC::INFINITY_OVERFLOW;
+
+    if (passIsFinite([&]() { kernels.linear(dst, coefs, srcs, count, n); }))
+        return RC::SUCCESS;
+
+    deferredOverflow = true;
+    return RC::INFINITY_OVERFLOW;
+}
+
+RC VectorOps::scale(double* dst, double multiplier, size_t n)
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+    {
+        if (!kernels.scaleIsFinite(dst, multiplier, n))
+            return RC::INFINITY_OVERFLOW;
+
+        kernels.scale(dst, dst, multiplier, n);
+        return RC::SUCCESS;
+    }
+
+    return runDeferred(dst, n, [&]() { kernels.scale(dst, dst, multiplier, n); },
+                       [](const auto& pass) { return passIsFinite(pass); });
+}
+
+RC VectorOps::apply(double* dst, size_t n, const std::function<double(double)>& fun)
+{
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+    {
+        return runEager(dst, n, [&](double* result) {
+            for (size_t i = 0; i < n; i++)
+                result[i] = fun(dst[i]);
+        });
+    }
+
+    // User function may return infinity without raising any flag, so the result is checked by a reduction
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    return runDeferred(dst, n, [&]() {
+                           for (size_t i = 0; i < n; i++)
+                               dst[i] = fun(dst[i]);
+                       },
+                       [&](const auto& pass) {
+                           pass();
+                           return kernels.isFinite(dst, n);
+                       });
+}
+
+RC VectorOps::applyBatch(double* dst, size_t n, const std::function<void(double*, size_t)>& fun)
+{
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+    {
+        return runEager(dst, n, [&](double* result) {
+            memcpy(result, dst, n * sizeof(double));
+            fun(result, n);
+        });
+    }
+
+    const VectorKernels::Table& kernels = VectorKernels::get();
+    return runDeferred(dst, n, [&]() { fun(dst, n); },
+                       [&](const auto& pass) {
+                           pass();
+                           return kernels.isFinite(dst, n);
+                       });
+}
+
+RC VectorOps::scatterAxpy(double* dst, const size_t* indices, const double* values, double multiplier, size_t nnz)
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+    {
+        if (!kernels.scatterAxpyIsFinite(dst, indices, values, multiplier, nnz))
+            return RC::INFINITY_OVERFLOW;
+
+        kernels.scatterAxpy(dst, indices, values, multiplier, nnz);
+        return RC::SUCCESS;
+    }
+
+    // Only the touched coordinates are saved for rollback, not the whole destination
+    const bool rollback = overflowCheck == IVector::OVERFLOW_CHECK::DEFERRED_ROLLBACK;
+    BufferLease lease(rollbackBuffer, rollback ? nnz : 0);
+    double* copy = lease.data;
+    if (rollback && nnz != 0)
+    {
+        if (copy == nullptr)
+            return RC::ALLOCATION_ERROR;
+
+        for (size_t k = 0; k < nnz; k++)
+            copy[k] = dst[indices[k]];
+    }
+
+    if (passIsFinite([&]() { kernels.scatterAxpy(dst, indices, values, multiplier, nnz); }))
+        return RC::SUCCESS;
+
+    deferredOverflow = true;
+    if (copy != nullptr)
+    {
+        for (size_t k = 0; k < nnz; k++)
+            dst[indices[k]] = copy[k];
+    }
+
+    return RC::INFINITY_OVERFLOW;
+}
+
+RC VectorOps::shiftColumns(double* dst, size_t stride, const double* shifts, size_t columns, size_t n)
+{
+    const VectorKernels::Table& kernels = VectorKernels::get();
+
+    if (overflowCheck == IVector::OVERFLOW_CHECK::EAGER)
+    {
+        for (size_t c = 0; c < columns; ++c)
+            if (!kernels.shiftIsFinite(dst + c * stride, shifts[c], n))
+                return RC::INFINITY_OVERFLOW;
+
+        for (size_t c = 0; c < columns; ++c)
+            kernels.shift(dst + c * stride, dst + c * stride, shifts[c], n);
+        return RC::SUCCESS;
+    }
+
+    return runDeferred(dst, columns * stride, [&]() {
+                           for (size_t c = 0; c < columns; ++c)
+                               kernels.shift(dst + c * stride, dst + c * stride, shifts[c], n);
+                       },
+                       [](const auto& pass) { return passIsFinite(pass); });
+}
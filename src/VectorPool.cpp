@@ -0,0 +1,577 @@
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <unordered_map>
+#include <vector>
+#include "../myHeaders/VectorPool.h"
+
+namespace
+{
+    enum class BlockKind : size_t
+    {
+        SYSTEM, // bypasses the pool
+        POOLED,
+        ARENA
+    };
+
+    struct BlockHeader
+    {
+        size_t size; // usable size of the block, header is not included
+        BlockKind kind;
+    };
+
+    const size_t headerSize = sizeof(BlockHeader);
+    const size_t granularity = 16;
+    // Header takes the end of a whole cache line in front of the block, so the block itself starts on a cache line
+    const size_t prefixSize = VectorPool::alignment;
+    const size_t smallClasses = 512;               // blocks up to 8 KiB have direct free list slots
+    const size_t maxPooledSize = 256 * 1024;       // bigger blocks go straight to the system
+    const size_t threadClassBytes = 256 * 1024;    // cache limit of a thread for one size class
+    const size_t minThreadClassBlocks = 8;
+    const size_t refillBlocks = 16;                // blocks taken from the depot at once
+    const size_t depotBytes = 64 * 1024 * 1024;
+
+    BlockHeader* headerOf(void* ptr)
+    {
+        return reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(ptr) - headerSize);
+    }
+
+    void* userOf(BlockHeader* header)
+    {
+        return reinterpret_cast<uint8_t*>(header) + headerSize;
+    }
+
+    BlockHeader* systemAllocate(size_t size, bool pooled)
+    {
+        void* base = ::operator new(prefixSize + size, std::align_val_t(VectorPool::alignment), std::nothrow);
+        if (base == nullptr)
+            return nullptr;
+
+        auto* header = reinterpret_cast<BlockHeader*>(static_cast<uint8_t*>(base) + prefixSize - headerSize);
+        header->size = size;
+        header->kind = pooled ? BlockKind::POOLED : BlockKind::SYSTEM;
+        return header;
+    }
+
+    void systemFree(BlockHeader* header)
+    {
+        ::operator delete(reinterpret_cast<uint8_t*>(header) + headerSize - prefixSize, std::align_val_t(VectorPool::alignment));
+    }
+
+    /*
+    * Counters are written only by the owning thread, relaxed atomics let statistics read them concurrently
+    */
+    struct Counters
+    {
+        std::atomic<size_t> allocations{0};
+        std::atomic<size_t> deallocations{0};
+        std::atomic<size_t> poolHits{0};
+        std::atomic<size_t> systemAllocations{0};
+        std::atomic<size_t> bytesAllocated{0};
+        std::atomic<size_t> bytesFreed{0};
+        std::atomic<size_t> bytesCached{0};
+    };
+
+    void add(std::atomic<size_t>& counter, size_t val)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) + val, std::memory_order_relaxed);
+    }
+
+    void subtract(std::atomic<size_t>& counter, size_t val)
+    {
+        counter.store(counter.load(std::memory_order_relaxed) - val, std::memory_order_relaxed);
+    }
+
+    /*
+    * Singly linked list of free blocks of one size, linked through their first word
+    */
+    struct FreeList
+    {
+        void* head = nullptr;
+        size_t count = 0;
+
+        void push(void* ptr)
+        {
+            *static_cast<void**>(ptr) = head;
+            head = ptr;
+            ++count;
+        }
+
+        void* pop()
+        {
+            void* ptr = head;
+            head = *static_cast<void**>(ptr);
+            --count;
+            return ptr;
+        }
+    };
+
+    class ThreadCache;
+
+    // Set once the cache of a finishing thread is destroyed, later frees bypass it
+    thread_local bool cacheDestroyed = false;
+
+    /*
+    * Blocks shared between threads and statistics of all threads
+    */
+    struct Depot
+    {
+        std::mutex mutex;
+        std::unordered_map<size_t, std::vector<void*>> blocks;
+        size_t bytesCached = 0;
+        std::vector<ThreadCache*> caches;
+        Counters retired;
+    };
+
+    // Never destroyed: vectors may be freed by destructors of other static objects
+    Depot& depot()
+    {
+        static Depot* instance = new Depot;
+        return *instance;
+    }
+
+    void sumCounters(const Counters& counters, IVector::PoolStats& stats)
+    {
+        stats.allocations += counters.allocations.load(std::memory_order_relaxed);
+        stats.deallocations += counters.deallocations.load(std::memory_order_relaxed);
+        stats.poolHits += counters.poolHits.load(std::memory_order_relaxed);
+        stats.systemAllocations += counters.systemAllocations.load(std::memory_order_relaxed);
+        stats.bytesInUse += counters.bytesAllocated.load(std::memory_order_relaxed);
+        stats.bytesInUse -= counters.bytesFreed.load(std::memory_order_relaxed);
+        stats.bytesCached += counters.bytesCached.load(std::memory_order_relaxed);
+    }
+
+    /*
+    * Takes up to count blocks of the given size from the depot
+    */
+    void takeFromDepot(size_t size, size_t count, FreeList& list)
+    {
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+
+        auto it = shared.blocks.find(size);
+        if (it == shared.blocks.end())
+            return;
+
+        std::vector<void*>& blocks = it->second;
+        while (count-- > 0 && !blocks.empty())
+        {
+            list.push(blocks.back());
+            blocks.pop_back();
+            shared.bytesCached -= size;
+        }
+    }
+
+    /*
+    * Gives count blocks from the list to the depot, blocks above the depot limit are freed
+    */
+    void giveToDepot(size_t size, size_t count, FreeList& list)
+    {
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+
+        std::vector<void*>* blocks = nullptr;
+        try
+        {
+            blocks = &shared.blocks[size];
+        }
+        catch (const std::bad_alloc&)
+        {
+        }
+
+        while (count-- > 0 && list.head != nullptr)
+        {
+            void* ptr = list.pop();
+            bool kept = false;
+
+            if (blocks != nullptr && shared.bytesCached + size <= depotBytes)
+            {
+                try
+                {
+                    blocks->push_back(ptr);
+                    shared.bytesCached += size;
+                    kept = true;
+                }
+                catch (const std::bad_alloc&)
+                {
+                }
+            }
+
+            if (!kept)
+                systemFree(headerOf(ptr));
+        }
+    }
+
+    class ThreadCache
+    {
+    public:
+        ThreadCache()
+        {
+            Depot& shared = depot();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.caches.push_back(this);
+        }
+
+        void* pop(size_t size)
+        {
+            FreeList* list = find(size, true);
+            if (list == nullptr)
+                return nullptr;
+
+            if (list->head == nullptr)
+            {
+                takeFromDepot(size, refillBlocks, *list);
+                add(counters.bytesCached, list->count * size);
+            }
+
+            if (list->head == nullptr)
+                return nullptr;
+
+            subtract(counters.bytesCached, size);
+            return list->pop();
+        }
+
+        /*
+        * Returns false if the block could not be cached
+        */
+        bool push(void* ptr, size_t size)
+        {
+            FreeList* list = find(size, true);
+            if (list == nullptr)
+                return false;
+
+            list->push(ptr);
+            add(counters.bytesCached, size);
+
+            if (list->count > minThreadClassBlocks && list->count * size > threadClassBytes)
+            {
+                const size_t surplus = list->count / 2;
+                giveToDepot(size, surplus, *list);
+                subtract(counters.bytesCached, surplus * size);
+            }
+            return true;
+        }
+
+        void release()
+        {
+            for (size_t idx = 0; idx < smallClasses; ++idx)
+                freeList(small[idx], idx * granularity);
+
+            for (auto& entry : large)
+                freeList(entry.second, entry.first);
+            large.clear();
+        }
+
+        ~ThreadCache()
+        {
+            for (size_t idx = 0; idx < smallClasses; ++idx)
+                giveList(small[idx], idx * granularity);
+
+            for (auto& entry : large)
+                giveList(entry.second, entry.first);
+
+            Depot& shared = depot();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            shared.caches.erase(std::remove(shared.caches.begin(), shared.caches.end(), this), shared.caches.end());
+
+            add(shared.retired.allocations, counters.allocations.load(std::memory_order_relaxed));
+            add(shared.retired.deallocations, counters.deallocations.load(std::memory_order_relaxed));
+            add(shared.retired.poolHits, counters.poolHits.load(std::memory_order_relaxed));
+            add(shared.retired.systemAllocations, counters.systemAllocations.load(std::memory_order_relaxed));
+            add(shared.retired.bytesAllocated, counters.bytesAllocated.load(std::memory_order_relaxed));
+            add(shared.retired.bytesFreed, counters.bytesFreed.load(std::memory_order_relaxed));
+
+            cacheDestroyed = true;
+        }
+
+        Counters counters;
+
+    private:
+        FreeList* find(size_t size, bool create)
+        {
+            if (size / granularity < smallClasses)
+                return &small[size / granularity];
+
+            auto it = large.find(size);
+            if (it != large.end())
+                return &it->second;
+
+            if (!create)
+                return nullptr;
+
+            try
+            {
+                return &large[size];
+            }
+            catch (const std::bad_alloc&)
+            {
+                return nullptr;
+            }
+        }
+
+        void freeList(FreeList& list, size_t size)
+        {
+            while (list.head != nullptr)
+            {
+                systemFree(headerOf(list.pop()));
+                subtract(counters.bytesCached, size);
+            }
+        }
+
+        void giveList(FreeList& list, size_t size)
+        {
+            const size_t count = list.count;
+            giveToDepot(size, count, list);
+            subtract(counters.bytesCached, count * size);
+        }
+
+        FreeList small[smallClasses];
+        std::unordered_map<size_t, FreeList> large;
+    };
+
+    thread_local ThreadCache cache;
+
+    /*
+    * Bump-pointer region of an arena, data follows the header
+    */
+    struct Region
+    {
+        Region* next;
+        size_t capacity;
+    };
+
+    const size_t regionHeaderSize = (sizeof(Region) + VectorPool::alignment - 1) / VectorPool::alignment * VectorPool::alignment;
+
+    struct ArenaState
+    {
+        ArenaState* previous;
+        Region* regions;
+        uint8_t* top;
+        uint8_t* limit;
+        size_t regionSize;
+        size_t bytesUsed;
+    };
+
+    thread_local ArenaState* currentArena = nullptr;
+
+    /*
+    * Bytes to skip at top, so that a block placed after them starts on a cache line
+    */
+    size_t arenaGap(const uint8_t* top)
+    {
+        const size_t misalignment = (reinterpret_cast<uintptr_t>(top) + headerSize) % VectorPool::alignment;
+        return misalignment == 0 ? 0 : VectorPool::alignment - misalignment;
+    }
+
+    void* arenaAllocate(ArenaState& arena, size_t size)
+    {
+        size_t need = headerSize + size;
+        if (arena.top != nullptr)
+            need += arenaGap(arena.top);
+
+        if (arena.top == nullptr || static_cast<size_t>(arena.limit - arena.top) < need)
+        {
+            const size_t capacity = std::max(arena.regionSize, prefixSize + size);
+            auto* region = static_cast<Region*>(::operator new(regionHeaderSize + capacity, std::align_val_t(VectorPool::alignment),
+                                                               std::nothrow));
+            if (region == nullptr)
+                return nullptr;
+
+            region->next = arena.regions;
+            region->capacity = capacity;
+            arena.regions = region;
+            arena.top = reinterpret_cast<uint8_t*>(region) + regionHeaderSize;
+            arena.limit = arena.top + capacity;
+            need = headerSize + size + arenaGap(arena.top);
+        }
+
+        auto* header = reinterpret_cast<BlockHeader*>(arena.top + arenaGap(arena.top));
+        header->size = size;
+        header->kind = BlockKind::ARENA;
+        arena.top += need;
+        arena.bytesUsed += headerSize + size;
+        return userOf(header);
+    }
+
+    /*
+    * Blocks are freed together with their arena, only the latest block of the current arena is given back,
+    * so create-delete loops keep reusing the same memory
+    */
+    void arenaDeallocate(BlockHeader* header)
+    {
+        ArenaState* arena = currentArena;
+        uint8_t* end = static_cast<uint8_t*>(userOf(header)) + header->size;
+        // Top may also stand after the alignment gap left by a block freed earlier
+        if (arena != nullptr && (arena->top == end || arena->top == end + arenaGap(end)))
+        {
+            arena->top = reinterpret_cast<uint8_t*>(header);
+            arena->bytesUsed -= headerSize + header->size;
+        }
+    }
+
+    /*
+    * Cache of the calling thread or nullptr if the thread is already finishing
+    */
+    ThreadCache* threadCache()
+    {
+        if (cacheDestroyed)
+            return nullptr;
+
+        return &cache;
+    }
+}
+
+void* VectorPool::allocate(size_t size)
+{
+    size = (size + granularity - 1) / granularity * granularity;
+
+    if (currentArena != nullptr)
+        return arenaAllocate(*currentArena, size);
+
+    ThreadCache* pCache = threadCache();
+    if (pCache == nullptr)
+    {
+        BlockHeader* header = systemAllocate(size, false);
+        if (header == nullptr)
+            return nullptr;
+
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        add(shared.retired.allocations, 1);
+        add(shared.retired.systemAllocations, 1);
+        add(shared.retired.bytesAllocated, size);
+        return userOf(header);
+    }
+
+    Counters& counters = pCache->counters;
+    BlockHeader* header = nullptr;
+
+    if (size <= maxPooledSize)
+    {
+        void* ptr = pCache->pop(size);
+        if (ptr != nullptr)
+        {
+            header = headerOf(ptr);
+            add(counters.poolHits, 1);
+        }
+    }
+
+    if (header == nullptr)
+    {
+        header = systemAllocate(size, size <= maxPooledSize);
+        if (header == nullptr)
+            return nullptr;
+
+        add(counters.systemAllocations, 1);
+    }
+
+    add(counters.allocations, 1);
+    add(counters.bytesAllocated, size);
+    return userOf(header);
+}
+
+void VectorPool::deallocate(void* ptr)
+{
+    if (ptr == nullptr)
+        return;
+
+    BlockHeader* header = headerOf(ptr);
+    const size_t size = header->size;
+
+    if (header->kind == BlockKind::ARENA)
+    {
+        arenaDeallocate(header);
+        return;
+    }
+
+    ThreadCache* pCache = threadCache();
+    if (pCache == nullptr)
+    {
+        Depot& shared = depot();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        add(shared.retired.deallocations, 1);
+        add(shared.retired.bytesFreed, size);
+        systemFree(header);
+        return;
+    }
+
+    add(pCache->counters.deallocations, 1);
+    add(pCache->counters.bytesFreed, size);
+
+    if (header->kind == BlockKind::SYSTEM || !pCache->push(ptr, size))
+        systemFree(header);
+}
+
+void VectorPool::getStats(IVector::PoolStats& stats)
+{
+    stats = IVector::PoolStats();
+
+    Depot& shared = depot();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    sumCounters(shared.retired, stats);
+    for (ThreadCache* pCache : shared.caches)
+        sumCounters(pCache->counters, stats);
+
+    stats.bytesCached += shared.bytesCached;
+}
+
+void VectorPool::release()
+{
+    ThreadCache* pCache = threadCache();
+    if (pCache != nullptr)
+        pCache->release();
+
+    Depot& shared = depot();
+    std::lock_guard<std::mutex> lock(shared.mutex);
+
+    for (auto& entry : shared.blocks)
+    {
+        for (void* ptr : entry.second)
+            systemFree(headerOf(ptr));
+    }
+
+    shared.blocks.clear();
+    shared.bytesCached = 0;
+}
+
+void* VectorPool::pushArena(size_t regionSize)
+{
+    auto* arena = new (std::nothrow) ArenaState();
+    if (arena == nullptr)
+        return nullptr;
+
+    arena->previous = currentArena;
+    arena->regionSize = (std::max(regionSize, granularity) + granularity - 1) / granularity * granularity;
+    currentArena = arena;
+    return arena;
+}
+
+void VectorPool::popArena(void* arena)
+{
+    auto* state = static_cast<ArenaState*>(arena);
+    if (state == nullptr)
+        return;
+
+    if (currentArena == state)
+        currentArena = state->previous;
+
+    while (state->regions != nullptr)
+    {
+        Region* next = state->regions->next;
+        ::operator delete(state->regions, std::align_val_t(VectorPool::alignment));
+        state->regions = next;
+    }
+
+    delete state;
+}
+
+size_t VectorPool::arenaBytesUsed(void const* arena)
+{
+    if (arena == nullptr)
+        return 0;
+
+    return static_cast<const ArenaState*>(arena)->bytesUsed;
+}
@@ -1,11 +1,26 @@
 #include "../include/IVector.h"
+#include "../include/IVectorView.h"
+#include "../include/IVectorExpr.h"
+#include "../include/IVectorBatch.h"
+#include "../include/IFloatVector.h"
+#include "../include/ISparseVector.h"
+#include "../include/IMappedVectorArray.h"
+#include "../include/IBinaryFormat.h"
+#include "../include/FixedVector.h"
 #include "../include/ISet.h"
 #include "../include/ILogger.h"
 #include "../include/RC.h"
 #include "../include/ICompact.h"
 #include "../myHeaders/NecessaryFuncs.h"
+#include "../myHeaders/VectorKernels.h"
 #include "../test/main.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
 #include <iostream>
+#include <utility>
+#include <vector>
 
 
 
@@ -75,6 +90,9 @@ void VectorTest()
     std::cout<<"\nEquals test :\n    ";
     std::cout<< "v1 == v2? ans: "<<IVector::equals(v1, v2, IVector::NORM::CHEBYSHEV, 0.001)<< "\n";
 
+    std::cout<<"\nDistance test :\n    ";
+    std::cout<< "|v1 - v2| = "<<IVector::distance(v1, v2, IVector::NORM::SECOND)<< "\n";
+
     std::cout<<"\ncopyInstance test v1->v3:\n";
     IVector::copyInstance(v3, v1);
     NecessaryFuncs::Print(v3, "v3");
@@ -92,6 +110,202 @@ void VectorTest()
         delete v1;
     }
 
+    std::cout<<"\nDeferred overflow test v3 += v3 (v3[0] == 1e308):\n";
+    IVector::setOverflowCheck(IVector::OVERFLOW_CHECK::DEFERRED_ROLLBACK);
+    v3->setCord(0, 1e308);
+    std::cout<< "    inc overflowed? ans: " << (v3->inc(v3) == RC::INFINITY_OVERFLOW) << "\n";
+    std::cout<< "    batch overflowed? ans: " << (IVector::checkDeferredOverflow() == RC::INFINITY_OVERFLOW) << "\n";
+    NecessaryFuncs::Print(v3, "v3");
+    IVector::setOverflowCheck(IVector::OVERFLOW_CHECK::EAGER);
+
+    std::cout<<"\nPool test delete + create of dimension 5:\n";
+    IVector::PoolStats stats;
+    IVector::getPoolStats(stats);
+    const size_t hits = stats.poolHits;
+    delete v_1;
+    v_1 = IVector::createVector(5, data);
+    IVector::getPoolStats(stats);
+    std::cout<< "    block reused? ans: " << (stats.poolHits == hits + 1) << "\n";
+    std::cout<< "    allocations: " << stats.allocations << ", deallocations: " << stats.deallocations << "\n";
+
+    std::cout<<"\nArena test v2 + v3 in a loop:\n";
+    {
+        IVector::getPoolStats(stats);
+        const size_t poolAllocations = stats.allocations;
+        IVector::Arena arena;
+        size_t usedByTemporary = 0;
+        for (size_t i = 0; i < 1000; ++i)
+        {
+            IVector* tmp = IVector::add(v2, v3);
+            usedByTemporary = std::max(usedByTemporary, arena.bytesUsed());
+            delete tmp;
+        }
+        IVector::getPoolStats(stats);
+        std::cout<< "    temporaries taken from the arena? ans: " << (usedByTemporary > 0) << "\n";
+        std::cout<< "    arena bytes used after the loop: " << arena.bytesUsed() << "\n";
+        std::cout<< "    pool untouched? ans: " << (stats.allocations == poolAllocations) << "\n";
+    }
+
+    std::cout<<"\nView test v2 + view over data:\n";
+    IVectorView view(5, data);
+    IVector* v4 = IVector::add(v2, &view);
+    NecessaryFuncs::Print(v4, "v4");
+    delete v4;
+
+    std::cout<<"\nLinear combination test v4 := 2 * v2 - v3:\n";
+    v4 = (2.0 * VectorExpr::term(v2) - v3).create();
+    NecessaryFuncs::Print(v4, "v4");
+    delete v4;
+
+    std::cout<<"\nBatch test distances from v2 to rows of data:\n    ";
+    IVectorBatch::setLogger(log);
+    double rows[] {2.5, 3.1, 6.7, 1.8, 9.5,
+                   0.0, 0.0, 0.0, 0.0, 0.0,
+                   1.0, 2.0, 3.0, 4.0, 5.0};
+    IVectorBatch* batch = IVectorBatch::createBatch(5, 3, rows);
+    double dists[3];
+    batch->distances(v2, IVector::NORM::SECOND, dists);
+    for (double d : dists)
+        std::cout<< d << "***";
+    std::cout<<"\n";
+    delete batch;
+    {
+        // -1e308 + 1e308 is exactly 0, although max|x| + |shift| is infinite
+        double extremes[] {-1e308, 1e308};
+        double overflowing[] {1e308, 1e308};
+        double cancelling[] {1e308, -1e308};
+        IVectorView up(2, overflowing), down(2, cancelling);
+        batch = IVectorBatch::createBatch(2, 1, extremes);
+        std::cout<< "    axpy of an overflowing shift rejected? ans: " << (batch->axpy(1.0, &up) == RC::INFINITY_OVERFLOW)
+                 << ", batch unchanged? ans: " << (batch->getColumn(0)[0] == -1e308) << "\n";
+        std::cout<< "    axpy of a cancelling shift succeeded? ans: " << (batch->axpy(1.0, &down) == RC::SUCCESS)
+                 << ", row: " << batch->getColumn(0)[0] << " " << batch->getColumn(1)[0] << "\n";
+        delete batch;
+    }
+
+    std::cout<<"\nFloat vector test f2 := float(v2):\n    ";
+    IFloatVector::setLogger(log);
+    IFloatVector* f2 = IFloatVector::createVector(v2);
+    std::cout<< "Norm 2 = " << f2->norm(IVector::NORM::SECOND) << "\n    ";
+    std::cout<< "f2 * v2 = " << IFloatVector::dot(f2, v2) << "\n";
+    delete f2;
+
+    std::cout<<"\nFixed vector test p := (2.5, 3.1, 6.7) on the stack, p += p:\n";
+    FixedVector<3> p(data);
+    p.inc(&p);
+    NecessaryFuncs::Print(&p, "p");
+
+    std::cout<<"\nParallel dot test of 2^21 coordinates with 1 and 4 threads:\n";
+    {
+        const size_t n = size_t(1) << 21;
+        double* big = new double[n];
+        for (size_t i = 0; i < n; ++i)
+            big[i] = 1.0 / (i + 1);
+        IVectorView bigView(n, big);
+        IVector::setThreadCount(1);
+        const double serial = IVector::dot(&bigView, &bigView);
+        IVector::setThreadCount(4);
+        const double parallel = IVector::dot(&bigView, &bigView);
+        IVector::setThreadCount(0);
+        std::cout<< "    results bitwise equal? ans: " << (serial == parallel) << "\n";
+        delete[] big;
+    }
+
+    std::cout<<"\nElementwise functions test v4 := log(exp(v2)), then v4 := sqrt(v4) clamped to [1, 10]:\n";
+    v4 = v2->clone();
+    v4->applyFunction(IVector::FUNCTION::EXP);
+    v4->applyFunction(IVector::FUNCTION::LOG);
+    std::cout<< "    v4 == v2? ans: " << IVector::equals(v4, v2, IVector::NORM::CHEBYSHEV, 1e-12) << "\n";
+    v4->applyFunction([](double x) { return std::sqrt(x); });
+    v4->clamp(1, 10);
+    NecessaryFuncs::Print(v4, "v4");
+    delete v4;
+
+    std::cout<<"\nKernel test: combinations, column, sparse and elementwise kernels of every ISA against scalar code:\n";
+    {
+        const size_t n = 1003;
+        std::vector<double> a(n), b(n), c(n);
+        std::vector<size_t> idx(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            a[i] = std::sin(i * 0.37) * 3;
+            b[i] = std::cos(i * 0.11) + 0.5;
+            c[i] = 0.1 + i * 1e-3;
+            idx[i] = (i * 7) % n;
+        }
+        const double coefs[] = {0.3, -1.7, 2.9};
+        const double* srcs[] = {a.data(), b.data(), c.data()};
+
+        // Every element is computed on its own, so all tables must give the same bits
+        auto outputs = [&](const VectorKernels::Table& k) {
+            std::vector<double> out;
+            std::vector<double> dst(n);
+            k.combine(dst.data(), a.data(), b.data(), -1, n);
+            out.insert(out.end(), dst.begin(), dst.end());
+            k.linear(dst.data(), coefs, srcs, 3, n);
+            out.insert(out.end(), dst.begin(), dst.end());
+            k.shift(dst.data(), a.data(), 0.3, n);
+            out.insert(out.end(), dst.begin(), dst.end());
+            dst = c;
+            k.columnAxpy(dst.data(), a.data(), 1.3, n);
+            out.insert(out.end(), dst.begin(), dst.end());
+            k.expValues(dst.data(), a.data(), n);
+            out.insert(out.end(), dst.begin(), dst.end());
+            k.logValues(dst.data(), c.data(), n);
+            out.insert(out.end(), dst.begin(), dst.end());
+            k.sigmoidValues(dst.data(), a.data(), n);
+            out.insert(out.end(), dst.begin(), dst.end());
+            dst = c;
+            k.scatterAxpy(dst.data(), idx.data(), b.data(), -0.7, n);
+            out.insert(out.end(), dst.begin(), dst.end());
+            return out;
+        };
+
+        const std::vector<double> scalar = outputs(VectorKernels::get(VectorKernels::ISA::SCALAR));
+        for (VectorKernels::ISA isa : {VectorKernels::ISA::SSE2, VectorKernels::ISA::AVX2, VectorKernels::ISA::AVX512})
+        {
+            const VectorKernels::Table& kernels = VectorKernels::get(isa);
+            const std::vector<double> other = outputs(kernels);
+            std::cout<< "    " << VectorKernels::isaName(kernels.isa) << " bitwise equal? ans: "
+                     << (std::memcmp(scalar.data(), other.data(), scalar.size() * sizeof(double)) == 0) << "\n";
+        }
+    }
+
+    std::cout<<"\nMapped vector test: v2 and v3 written to a mapped file, second one mapped back read-only:\n";
+    IMappedVectorArray::setLogger(log);
+    IMappedVectorArray* mapped = IMappedVectorArray::createArray("mapped_vectors.bin", 5, 2, IMappedVectorArray::MODE::READ_WRITE);
+    mapped->setCoords(0, v2);
+    mapped->setCoords(1, v3);
+    delete mapped;
+    v4 = IMappedVectorArray::createVector("mapped_vectors.bin", 5, IMappedVectorArray::MODE::READ_ONLY, 5 * sizeof(double));
+    NecessaryFuncs::Print(v4, "v4");
+    std::cout<< "    v4 == v3? ans: " << IVector::equals(v4, v3, IVector::NORM::CHEBYSHEV, 0) << "\n";
+    delete v4;
+    std::remove("mapped_vectors.bin");
+
+    std::cout<<"\nVectorPtr test: s := v2 + v3 held by an owning handle, then moved to another one:\n";
+    {
+        VectorPtr s = IVector::addPtr(v2, v3);
+        VectorPtr moved = std::move(s);
+        std::cout<< "    first handle empty? ans: " << (s == nullptr) << "\n";
+        NecessaryFuncs::Print(moved.get(), "moved");
+    }
+
+    std::cout<<"\nSparse vector test g := (0, 0, 1, 0, -2), v4 := v2 + 2 * g:\n";
+    {
+        ISparseVector::setLogger(log);
+        const size_t indices[] = {2, 4};
+        const double values[] = {1.0, -2.0};
+        ISparseVector* g = ISparseVector::createVector(5, 2, indices, values);
+        std::cout<< "    Norm 1 = " << g->norm(IVector::NORM::FIRST) << "\n";
+        std::cout<< "    g * v2 = " << ISparseVector::dot(g, v2) << "\n";
+        v4 = v2->clone();
+        ISparseVector::axpy(v4, 2.0, g);
+        NecessaryFuncs::Print(v4, "v4");
+        delete v4;
+        delete g;
+    }
+
 
     delete v1;
     delete v2;
@@ -157,6 +371,74 @@ void SetTest()
     NecessaryFuncs::Print(subSet, "Sub");
     NecessaryFuncs::Print(symSubSet, "Symsub");
 
+    std::cout<<"\nParallel set operations test: 3000 vectors in each set, half of them shared, 4 threads:\n";
+    {
+        const size_t count = 3000;
+        double* rows1 = new double[2 * count];
+        double* rows2 = new double[2 * count];
+        for (size_t i = 0; i < count; ++i)
+        {
+            rows1[2 * i] = double(i);
+            rows1[2 * i + 1] = double(i % 7);
+            rows2[2 * i] = double(i + count / 2);
+            rows2[2 * i + 1] = double((i + count / 2) % 7);
+        }
+        ISet* big1 = ISet::createSet();
+        ISet* big2 = ISet::createSet();
+        big1->insertBatch(rows1, 2, count, IVector::NORM::FIRST, 0);
+        big2->insertBatch(rows2, 2, count, IVector::NORM::FIRST, 0);
+
+        // Same vectors in the same order
+        auto sameRows = [](ISet const* op1, ISet const* op2)
+        {
+            if (op1 == nullptr || op2 == nullptr || op1->getSize() != op2->getSize())
+                return false;
+            VectorPtr row1, row2;
+            for (size_t i = 0; i < op1->getSize(); ++i)
+            {
+                op1->getCopy(i, row1);
+                op2->getCopy(i, row2);
+                if (!IVector::equals(row1.get(), row2.get(), IVector::NORM::CHEBYSHEV, 0))
+                    return false;
+            }
+            return true;
+        };
+
+        IVector::setThreadCount(4);
+        ISet* sequential[4] = {
+            ISet::makeIntersection(big1, big2, IVector::NORM::FIRST, tol),
+            ISet::makeUnion(big1, big2, IVector::NORM::FIRST, tol),
+            ISet::sub(big1, big2, IVector::NORM::FIRST, tol),
+            ISet::symSub(big1, big2, IVector::NORM::FIRST, tol)};
+        ISet* parallel[4] = {
+            ISet::makeIntersection(big1, big2, IVector::NORM::FIRST, tol, ISet::EXECUTION::PARALLEL),
+            ISet::makeUnion(big1, big2, IVector::NORM::FIRST, tol, ISet::EXECUTION::PARALLEL),
+            ISet::sub(big1, big2, IVector::NORM::FIRST, tol, ISet::EXECUTION::PARALLEL),
+            ISet::symSub(big1, big2, IVector::NORM::FIRST, tol, ISet::EXECUTION::PARALLEL)};
+        const char* names[4] = {"intersection", "union", "sub", "symSub"};
+        for (size_t k = 0; k < 4; ++k)
+        {
+            std::cout<< "    " << names[k] << " of " << (sequential[k] ? sequential[k]->getSize() : 0)
+                     << " vectors same as sequential? ans: " << sameRows(sequential[k], parallel[k]) << "\n";
+        }
+        std::cout<< "    subSet same as sequential? ans: "
+                 << (ISet::subSet(sequential[0], big1, IVector::NORM::FIRST, tol, ISet::EXECUTION::PARALLEL) ==
+                     ISet::subSet(sequential[0], big1, IVector::NORM::FIRST, tol) &&
+                     ISet::subSet(big1, big2, IVector::NORM::FIRST, tol, ISet::EXECUTION::PARALLEL) ==
+                     ISet::subSet(big1, big2, IVector::NORM::FIRST, tol)) << "\n";
+        IVector::setThreadCount(0);
+
+        for (size_t k = 0; k < 4; ++k)
+        {
+            delete sequential[k];
+            delete parallel[k];
+        }
+        delete big1;
+        delete big2;
+        delete[] rows1;
+        delete[] rows2;
+    }
+
     std::cout<<"\nCopy test: \n";
     set1->getCopy(0, temp_v);
     NecessaryFuncs::Print(temp_v, "Copied vec");
@@ -196,6 +478,119 @@ void SetTest()
     err = set1->findFirstAndCopy(vec4, IVector::NORM::FIRST, tol, temp_v);
     NecessaryFuncs::Print(temp_v, "result");
 
+    std::cout<<"\nBinary format test: set1 saved to a file, mapped back and read back:\n";
+    IBinaryFormat::setLogger(log);
+    IBinaryFormat::save("set1.bin", set1);
+    IMappedVectorArray* mappedSet = IBinaryFormat::mapSet("set1.bin");
+    std::cout<< "    mapped vectors: " << mappedSet->getSize() << "\n";
+    delete mappedSet;
+    {
+        const size_t size = IBinaryFormat::getSize(set1);
+        double* record = new double[size / sizeof(double)];
+        IBinaryFormat::write(set1, record, size);
+        ISet* restored = IBinaryFormat::readSet(record, size);
+        std::cout<< "    restored == set1? ans: " << ISet::equals(restored, set1, IVector::NORM::CHEBYSHEV, 0) << "\n";
+        delete restored;
+        delete[] record;
+    }
+    std::remove("set1.bin");
+    {
+        ISet* empty = ISet::createSet();
+        IBinaryFormat::save("empty.bin", empty);
+        IMappedVectorArray* mappedEmpty = IBinaryFormat::mapSet("empty.bin");
+        std::cout<< "    empty set mapped? ans: " << (mappedEmpty != nullptr && mappedEmpty->getSize() == 0) << "\n";
+        delete mappedEmpty;
+
+        const size_t size = IBinaryFormat::getSize(empty);
+        double* record = new double[size / sizeof(double)];
+        IBinaryFormat::write(empty, record, size);
+        ISet* restored = IBinaryFormat::readSet(record, size);
+        std::cout<< "    empty set read back? ans: " << (restored != nullptr && restored->getSize() == 0) << "\n";
+        delete restored;
+        delete[] record;
+        delete empty;
+        std::remove("empty.bin");
+    }
+    {
+        const size_t size = IBinaryFormat::getSize(vec1);
+        double* record = new double[size / sizeof(double)];
+        IBinaryFormat::write(vec1, record, size);
+        record[size / sizeof(double) - 1] = NAN;
+        IVector* restored = IBinaryFormat::readVector(record, size);
+        std::cout<< "    vector record with NaN rejected? ans: " << (restored == nullptr) << "\n";
+        delete restored;
+        delete[] record;
+    }
+
+    std::cout<<"\nHashed set test: vec1, vec2, vec3 and vec1 again inserted with the metric of the set, norm 2 and tol 0.5:\n";
+    {
+        ISet* hashed = ISet::createSet(IVector::NORM::SECOND, 0.5);
+        hashed->insert(vec1);
+        hashed->insert(vec2);
+        hashed->insert(vec3);
+        err = hashed->insert(vec1);
+        std::cout<< "    size: " << hashed->getSize() << ", duplicate rejected? ans: " << (err == RC::VECTOR_ALREADY_EXIST) << "\n";
+
+        // Both are 0.4 from vec1 along each axis they move, the second one is farther than 0.5 in norm 2
+        double nearData[] = {1.4, 0, 2};
+        double diagonalData[] = {1.4, 0.4, 2};
+        IVectorView nearView(3, nearData), diagonalView(3, diagonalData);
+        std::cout<< "    (1.4, 0, 2) found? ans: " << (hashed->findFirst(&nearView) == RC::SUCCESS)
+                 << ", (1.4, 0.4, 2) found? ans: " << (hashed->findFirst(&diagonalView) == RC::SUCCESS) << "\n";
+        delete hashed;
+    }
+
+    std::cout<<"\nIndex rounding test: pattern within tol of a row next to a split of the index:\n";
+    {
+        const double nearX = -0.028479709131969962;
+        const double pat[2] = {0.94735501511311426, 0};
+        const double patTol = 0.97583472424508422;
+        double rows[32] = {nearX, 0, std::nextafter(nearX, HUGE_VAL), 100};
+        for (size_t idx = 0; idx < 7; ++idx)
+        {
+            rows[4 + 4 * idx] = -100.0 - idx;
+            rows[5 + 4 * idx] = 0;
+            rows[6 + 4 * idx] = 100.0 + idx;
+            rows[7 + 4 * idx] = 0;
+        }
+        ISet* indexed = ISet::createSet();
+        indexed->insertBatch(rows, 2, 16, IVector::NORM::CHEBYSHEV, 0);
+        IVector* patVec = IVector::createVector(2, pat);
+        std::cout<< "    found? ans: " << (indexed->findFirst(patVec, IVector::NORM::CHEBYSHEV, patTol) == RC::SUCCESS)
+                 << ", duplicate rejected? ans: "
+                 << (indexed->insert(patVec, IVector::NORM::CHEBYSHEV, patTol) == RC::VECTOR_ALREADY_EXIST) << "\n";
+        delete patVec;
+        delete indexed;
+    }
+
+    std::cout<<"\nBatch insert test: 4 rows, the second one within tol of the first:\n";
+    {
+        double rows[12] = {1, 2, 3, 1, 2, 3.5, 4, 5, 6, 7, 8, 9};
+        RC statuses[4];
+        ISet* batchSet = ISet::createSet();
+        batchSet->insertBatch(rows, 3, 4, IVector::NORM::SECOND, 1.0, statuses);
+        std::cout<< "    size: " << batchSet->getSize() << ", second row rejected? ans: "
+                 << (statuses[1] == RC::VECTOR_ALREADY_EXIST) << "\n";
+        delete batchSet;
+    }
+
+    std::cout<<"\nReserve test: clone of set1 reserved for 1000 vectors, then shrunk, and a set on huge pages:\n";
+    {
+        ISet* reserved = set1->clone();
+        err = reserved->reserve(1000);
+        reserved->insert(vec1, IVector::NORM::FIRST, 1.e-4);
+        reserved->shrinkToFit();
+        std::cout<< "    reserved? ans: " << (err == RC::SUCCESS) << ", size: " << reserved->getSize() << "\n";
+        delete reserved;
+
+        ISet* huge = ISet::createSet();
+        huge->reserve(1000, true);
+        huge->insert(vec1, IVector::NORM::FIRST, 1.e-4);
+        err = huge->reserve(5000);
+        std::cout<< "    plain reserve after huge pages succeeded? ans: " << (err == RC::SUCCESS) << "\n";
+        delete huge;
+    }
+
 
     delete set;
     delete vec1;
@@ -241,6 +636,14 @@ void SetIteratorTest()
     std::cout<<"    vector == vec3?\n   Ans:  " << IVector::equals(vec3, vector, IVector::NORM::CHEBYSHEV, 0.001) << "\n";
     delete vector;
 
+    vector = nullptr;
+    set->remove(1);
+    iterator1->next();
+    iterator1->getVectorCopy(vector);
+    std::cout<<"\nRemove test: vec2 removed, next of the iterator at vec1\n";
+    std::cout<<"    vector == vec3?\n   Ans:  " << IVector::equals(vec3, vector, IVector::NORM::CHEBYSHEV, 0.001) << "\n";
+    delete vector;
+
 
 
 